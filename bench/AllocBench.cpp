@@ -0,0 +1,62 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+// Small-tensor calls where the per-call allocations of the compat wrappers,
+// not the kernels, dominate. Every case reports allocs_per_iter and
+// alloc_bytes_per_iter; compare the two backends with
+// tools/bench_compare.py <build_dir> Alloc.
+BENCH_SUITE(AllocBench) {
+  for (int64_t numel : {1, 16, 1024}) {
+    std::string size = std::to_string(numel);
+    RegisterBenchmark(CaseName({"abs", size}), [numel]() -> BenchBody {
+      at::Tensor input = MakeInput({numel}, at::kFloat);
+      return [input]() { DoNotOptimize(at::abs(input)); };
+    });
+    RegisterBenchmark(CaseName({"cat", size}), [numel]() -> BenchBody {
+      std::vector<at::Tensor> inputs = {MakeInput({numel}, at::kFloat),
+                                        MakeInput({numel}, at::kFloat)};
+      return [inputs]() { DoNotOptimize(at::cat(inputs, 0)); };
+    });
+    RegisterBenchmark(CaseName({"reshape", size}), [numel]() -> BenchBody {
+      at::Tensor input = MakeInput({numel}, at::kFloat);
+      return [input, numel]() { DoNotOptimize(input.reshape({1, numel})); };
+    });
+    RegisterBenchmark(
+        CaseName({"toType_same", size}), [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel}, at::kFloat);
+          return [input]() { DoNotOptimize(input.toType(at::kFloat)); };
+        });
+    RegisterBenchmark(
+        CaseName({"toType_double", size}), [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel}, at::kFloat);
+          return [input]() { DoNotOptimize(input.toType(at::kDouble)); };
+        });
+    RegisterBenchmark(CaseName({"sum", size}), [numel]() -> BenchBody {
+      at::Tensor input = MakeInput({numel}, at::kFloat);
+      return [input]() { DoNotOptimize(at::sum(input)); };
+    });
+    RegisterBenchmark(CaseName({"sum_out", size}), [numel]() -> BenchBody {
+      at::Tensor input = MakeInput({numel}, at::kFloat);
+      at::Tensor output = at::zeros({}, at::kFloat);
+      return [input, output]() mutable {
+        DoNotOptimize(at::sum_out(output, input));
+      };
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace at
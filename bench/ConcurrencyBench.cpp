@@ -0,0 +1,150 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/zeros.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Tensor lifecycles per benchmark iteration, split evenly over the threads
+// and rounded down, so the threads<N> cases do about the same total work.
+// The scaling summary compares ns_per_item, which the rounding does not
+// skew.
+constexpr int kOpsPerIter = 4096;
+
+// Threads started once per case and released together for every iteration,
+// so thread creation stays out of the measurement.
+class WorkerPool {
+ public:
+  WorkerPool(int num_threads, std::function<void(int)> work)
+      : work_(std::move(work)) {
+    for (int t = 0; t < num_threads; ++t) {
+      threads_.emplace_back([this, t]() { Loop(t); });
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Runs work on every thread and waits for all of them.
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_ = static_cast<int>(threads_.size());
+    ++generation_;
+    start_.notify_all();
+    done_.wait(lock, [this]() { return pending_ == 0; });
+  }
+
+ private:
+  void Loop(int thread_index) {
+    int64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+      }
+      work_(thread_index);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::function<void(int)> work_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  int64_t generation_ = 0;
+  int pending_ = 0;
+  bool stop_ = false;
+};
+
+using Lifecycle = std::function<void(const at::Tensor&)>;
+
+void RegisterLifecycle(const std::string& op, const Lifecycle& lifecycle) {
+  for (int threads : ThreadSweep()) {
+    int ops_per_thread = kOpsPerIter / threads;
+    RegisterBenchmark(
+        CaseName({"lifecycle", op, "threads" + std::to_string(threads)}),
+        [lifecycle, threads, ops_per_thread]() -> BenchBody {
+          // Shared by every thread, for the refcount cases.
+          at::Tensor shared = MakeInput({16, 16}, at::kFloat);
+          auto pool = std::make_shared<WorkerPool>(
+              threads, [lifecycle, shared, ops_per_thread](int) {
+                for (int i = 0; i < ops_per_thread; ++i) {
+                  lifecycle(shared);
+                }
+              });
+          return [pool]() { pool->Run(); };
+        },
+        0,
+        ops_per_thread * threads);
+  }
+}
+
+}  // namespace
+
+// Tensor creation and destruction from many threads at once. Each case
+// performs kOpsPerIter lifecycles per iteration; ns_per_item is the inverse
+// throughput and the scaling table shows speedup against one thread. Poor
+// efficiency on the factory cases points at a lock in the allocator, on
+// shared_copy at contention on the shared refcount.
+BENCH_SUITE(ConcurrencyBench) {
+  RegisterLifecycle("zeros", [](const at::Tensor&) {
+    DoNotOptimize(at::zeros({16, 16}, at::kFloat));
+  });
+  RegisterLifecycle("ones", [](const at::Tensor&) {
+    DoNotOptimize(at::ones({16, 16}, at::kFloat));
+  });
+  RegisterLifecycle("empty", [](const at::Tensor&) {
+    DoNotOptimize(at::empty({16, 16}, at::kFloat));
+  });
+  RegisterLifecycle("reshape", [](const at::Tensor&) {
+    at::Tensor tensor = at::empty({16, 16}, at::kFloat);
+    DoNotOptimize(tensor.reshape({256}));
+  });
+  RegisterLifecycle("cat", [](const at::Tensor&) {
+    at::Tensor tensor = at::empty({4, 16}, at::kFloat);
+    DoNotOptimize(at::cat({tensor, tensor}, 0));
+  });
+  RegisterLifecycle("shared_copy", [](const at::Tensor& shared) {
+    at::Tensor copy = shared;
+    DoNotOptimize(copy);
+  });
+  RegisterLifecycle("shared_view", [](const at::Tensor& shared) {
+    DoNotOptimize(shared.reshape({256}));
+  });
+  RegisterThreadScalingSummary();
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,128 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+const std::vector<at::ScalarType>& ConversionTypes() {
+  static const std::vector<at::ScalarType> types = {at::kBool,
+                                                    at::kByte,
+                                                    at::kChar,
+                                                    at::kShort,
+                                                    at::kInt,
+                                                    at::kLong,
+                                                    at::kHalf,
+                                                    at::kBFloat16,
+                                                    at::kFloat,
+                                                    at::kDouble};
+  return types;
+}
+
+const std::vector<int64_t>& ConversionSizes() {
+  static const std::vector<int64_t> sizes = {1024, 64 * 1024, 4 << 20};
+  return sizes;
+}
+
+// Case name -> (from, to) of the toType cases at the largest size.
+std::map<std::string, std::pair<at::ScalarType, at::ScalarType>>&
+MatrixCases() {
+  static std::map<std::string, std::pair<at::ScalarType, at::ScalarType>>
+      cases;
+  return cases;
+}
+
+// Prints GB/s (bytes read plus written) of every pair at the largest size
+// as a from x to matrix.
+void PrintConversionMatrix(std::vector<BenchResult>* results) {
+  std::map<std::pair<at::ScalarType, at::ScalarType>, double> gbps;
+  for (const BenchResult& result : *results) {
+    auto it = MatrixCases().find(result.name);
+    if (it != MatrixCases().end() && result.median_ns > 0) {
+      gbps[it->second] = result.bytes_per_iter / result.median_ns;
+    }
+  }
+  if (gbps.empty()) {
+    return;
+  }
+  char cell[32];
+  std::cout << "\ntoType GB/s at " << ConversionSizes().back()
+            << " elements (rows: from, columns: to)\n"
+            << "          ";
+  for (at::ScalarType to : ConversionTypes()) {
+    std::snprintf(cell, sizeof(cell), "%9s", DtypeName(to));
+    std::cout << cell;
+  }
+  std::cout << std::endl;
+  for (at::ScalarType from : ConversionTypes()) {
+    std::snprintf(cell, sizeof(cell), "%-10s", DtypeName(from));
+    std::cout << cell;
+    for (at::ScalarType to : ConversionTypes()) {
+      auto it = gbps.find({from, to});
+      if (it == gbps.end()) {
+        std::snprintf(cell, sizeof(cell), "%9s", "-");
+      } else {
+        std::snprintf(cell, sizeof(cell), "%9.2f", it->second);
+      }
+      std::cout << cell;
+    }
+    std::cout << std::endl;
+  }
+}
+
+}  // namespace
+
+// toType between every pair of CPU scalar types. A pair far below its
+// neighbours in the summary matrix usually runs a scalar loop. The "to"
+// cases check that to(dtype) costs the same as toType.
+BENCH_SUITE(DtypeConversionBench) {
+  for (at::ScalarType from : ConversionTypes()) {
+    for (at::ScalarType to : ConversionTypes()) {
+      if (from == to) {
+        continue;
+      }
+      int64_t elem_bytes = DtypeSize(from) + DtypeSize(to);
+      for (int64_t numel : ConversionSizes()) {
+        std::string name = CaseName(
+            {"toType", DtypeName(from), DtypeName(to), std::to_string(numel)});
+        if (numel == ConversionSizes().back()) {
+          MatrixCases()[name] = {from, to};
+        }
+        RegisterBenchmark(
+            name,
+            [from, to, numel]() -> BenchBody {
+              at::Tensor input = MakeInput({numel}, from);
+              return [input, to]() { DoNotOptimize(input.toType(to)); };
+            },
+            elem_bytes * numel,
+            numel);
+        if (from != at::kFloat) {
+          continue;
+        }
+        RegisterBenchmark(
+            CaseName(
+                {"to", DtypeName(from), DtypeName(to), std::to_string(numel)}),
+            [from, to, numel]() -> BenchBody {
+              at::Tensor input = MakeInput({numel}, from);
+              return [input, to]() { DoNotOptimize(input.to(to)); };
+            },
+            elem_bytes * numel,
+            numel);
+      }
+    }
+  }
+  RegisterSummary(PrintConversionMatrix);
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,188 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/empty_like.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/zeros.h>
+#include <ATen/ops/zeros_like.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+using Factory = std::function<at::Tensor()>;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t MinorFaults() {
+  rusage usage;
+  return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_minflt : 0;
+}
+
+int64_t PageSize() {
+  long page = sysconf(_SC_PAGESIZE);
+  return page > 0 ? page : 4096;
+}
+
+// Largest tensor to create. FACTORY_BENCH_MAX_BYTES overrides the default
+// of 4GB capped at half the physical memory.
+int64_t MaxBytes() {
+  const char* env = std::getenv("FACTORY_BENCH_MAX_BYTES");
+  if (env != nullptr && std::atoll(env) > 0) {
+    return std::atoll(env);
+  }
+  int64_t physical = static_cast<int64_t>(sysconf(_SC_PHYS_PAGES)) *
+                     static_cast<int64_t>(PageSize());
+  int64_t limit = int64_t{4} << 30;
+  return physical > 0 ? std::min(limit, physical / 2) : limit;
+}
+
+// Per-phase means over every run of a case.
+struct PhaseTotals {
+  int64_t runs = 0;
+  double create_ns = 0;
+  double touch_ns = 0;
+  double fill_ns = 0;
+  double destroy_ns = 0;
+  double create_faults = 0;
+  double touch_faults = 0;
+};
+
+// One lifecycle per iteration, timed phase by phase:
+//   create  - the factory call itself
+//   touch   - writing one byte per page; page faults here mean the factory
+//             left the pages unmapped (lazily zeroed or never written)
+//   fill    - fill_ over the now resident memory, i.e. what an eager
+//             memset costs once the faults are paid
+//   destroy - releasing the tensor
+// zeros_lazy is 1 when zeros/zeros_like take most of their page faults in
+// the touch phase, i.e. the memory came back zeroed from the OS instead of
+// being memset, 0 when they fault while creating, and -1 when neither
+// phase faults (pages reused from the heap, where laziness cannot be told).
+void RegisterLifecycle(const std::string& op,
+                       int64_t bytes,
+                       const std::function<Factory()>& setup) {
+  int64_t page = PageSize();
+  int64_t pages = (bytes + page - 1) / page;
+  bool is_zeros = op == "zeros" || op == "zeros_like";
+  RegisterBenchmark(
+      CaseName({"lifecycle", op, std::to_string(bytes >> 20) + "MB"}),
+      [setup, page, pages, bytes, is_zeros]() -> BenchBody {
+        Factory factory = setup();
+        auto totals = std::make_shared<PhaseTotals>();
+        return [factory, totals, page, pages, bytes, is_zeros]() {
+          int64_t faults0 = MinorFaults();
+          int64_t t0 = NowNs();
+          at::Tensor tensor = factory();
+          int64_t t1 = NowNs();
+          int64_t faults1 = MinorFaults();
+          volatile char* data = static_cast<char*>(tensor.data_ptr());
+          for (int64_t i = 0; i < bytes; i += page) {
+            data[i] = 0;
+          }
+          int64_t t2 = NowNs();
+          int64_t faults2 = MinorFaults();
+          tensor.fill_(1);
+          int64_t t3 = NowNs();
+          tensor = at::Tensor();
+          int64_t t4 = NowNs();
+
+          PhaseTotals& sum = *totals;
+          ++sum.runs;
+          sum.create_ns += t1 - t0;
+          sum.touch_ns += t2 - t1;
+          sum.fill_ns += t3 - t2;
+          sum.destroy_ns += t4 - t3;
+          sum.create_faults += faults1 - faults0;
+          sum.touch_faults += faults2 - faults1;
+
+          double runs = static_cast<double>(sum.runs);
+          ReportCounter("create_ms", sum.create_ns / runs / 1e6);
+          ReportCounter("touch_ms", sum.touch_ns / runs / 1e6);
+          ReportCounter("fill_ms", sum.fill_ns / runs / 1e6);
+          ReportCounter("destroy_ms", sum.destroy_ns / runs / 1e6);
+          ReportCounter("fill_gb_per_s", bytes / (sum.fill_ns / runs));
+          ReportCounter("create_faults_per_page",
+                        sum.create_faults / runs / pages);
+          ReportCounter("touch_faults_per_page",
+                        sum.touch_faults / runs / pages);
+          if (is_zeros) {
+            double lazy = -1;
+            if (sum.create_faults + sum.touch_faults > 0) {
+              lazy = sum.touch_faults > sum.create_faults ? 1 : 0;
+            }
+            ReportCounter("zeros_lazy", lazy);
+          }
+        };
+      },
+      // The lifecycle has no single byte count; fill_gb_per_s is the
+      // bandwidth figure.
+      0,
+      bytes / DtypeSize(at::kFloat));
+}
+
+}  // namespace
+
+// Factory ops on large float32 buffers, from 16MB up to several GB
+// (capped by FACTORY_BENCH_MAX_BYTES). For short-lived large buffers the
+// page faults and eager zeroing dominate; the per-phase counters show where
+// each backend pays them.
+BENCH_SUITE(FactoryFirstTouchBench) {
+  int64_t max_bytes = MaxBytes();
+  for (int64_t bytes : {int64_t{16} << 20,
+                        int64_t{256} << 20,
+                        int64_t{1} << 30,
+                        int64_t{4} << 30}) {
+    if (bytes > max_bytes) {
+      continue;
+    }
+    int64_t numel = bytes / DtypeSize(at::kFloat);
+    at::TensorOptions options = at::TensorOptions().dtype(at::kFloat);
+    RegisterLifecycle("zeros", bytes, [numel, options]() -> Factory {
+      return [numel, options]() { return at::zeros({numel}, options); };
+    });
+    RegisterLifecycle("ones", bytes, [numel, options]() -> Factory {
+      return [numel, options]() { return at::ones({numel}, options); };
+    });
+    RegisterLifecycle("full", bytes, [numel, options]() -> Factory {
+      return [numel, options]() { return at::full({numel}, 5, options); };
+    });
+    RegisterLifecycle("empty", bytes, [numel, options]() -> Factory {
+      return [numel, options]() { return at::empty({numel}, options); };
+    });
+    RegisterLifecycle("arange", bytes, [numel, options]() -> Factory {
+      return [numel, options]() { return at::arange(numel, options); };
+    });
+    // The prototypes are never written, so they stay out of the RSS.
+    RegisterLifecycle("empty_like", bytes, [numel, options]() -> Factory {
+      at::Tensor prototype = at::empty({numel}, options);
+      return [prototype]() { return at::empty_like(prototype); };
+    });
+    RegisterLifecycle("zeros_like", bytes, [numel, options]() -> Factory {
+      at::Tensor prototype = at::empty({numel}, options);
+      return [prototype]() { return at::zeros_like(prototype); };
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace at
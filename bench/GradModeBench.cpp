@@ -0,0 +1,216 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+#include <c10/core/InferenceMode.h>
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Ops on small tensors cost well under a microsecond, so every iteration
+// makes this many calls under one guard and results are read per item.
+constexpr int64_t kCallsPerIter = 100;
+
+enum class Mode { kDefault, kRequiresGrad, kNoGrad, kInferenceMode };
+
+const char* ModeName(Mode mode) {
+  switch (mode) {
+    case Mode::kDefault:
+      return "default";
+    case Mode::kRequiresGrad:
+      return "requires_grad";
+    case Mode::kNoGrad:
+      return "no_grad";
+    case Mode::kInferenceMode:
+      return "inference_mode";
+  }
+  return "unknown";
+}
+
+// Runs calls under the guard of mode. requires_grad runs without a guard on
+// an input that requires grad, i.e. the full autograd bookkeeping.
+void RunUnder(Mode mode, const std::function<void()>& calls) {
+  switch (mode) {
+    case Mode::kNoGrad: {
+      at::NoGradGuard guard;
+      calls();
+      break;
+    }
+    case Mode::kInferenceMode: {
+      c10::InferenceMode guard;
+      calls();
+      break;
+    }
+    default:
+      calls();
+  }
+}
+
+using SmallOp = std::function<at::Tensor(const at::Tensor&)>;
+
+const std::vector<std::pair<const char*, SmallOp>>& SmallOps() {
+  static const std::vector<std::pair<const char*, SmallOp>> ops = {
+      {"abs", [](const at::Tensor& t) { return at::abs(t); }},
+      {"sum", [](const at::Tensor& t) { return at::sum(t); }},
+      {"sum_dim", [](const at::Tensor& t) { return at::sum(t, {0}, false); }},
+      {"reshape", [](const at::Tensor& t) { return t.reshape({-1}); }},
+      {"cat",
+       [](const at::Tensor& t) {
+         std::vector<at::Tensor> inputs = {t, t};
+         return at::cat(inputs, 0);
+       }},
+      {"zeros",
+       [](const at::Tensor& t) { return at::zeros(t.sizes(), at::kFloat); }},
+  };
+  return ops;
+}
+
+// Case name -> (op/shape group, mode), for the summary.
+std::map<std::string, std::pair<std::string, Mode>>& ModeCases() {
+  static std::map<std::string, std::pair<std::string, Mode>> cases;
+  return cases;
+}
+
+// Prints the per-call time and allocations of every guarded mode relative
+// to the default mode of the same op and shape.
+void PrintModeSummary(std::vector<BenchResult>* results) {
+  std::map<std::string, std::map<Mode, BenchResult*>> groups;
+  std::vector<std::string> order;
+  for (BenchResult& result : *results) {
+    auto it = ModeCases().find(result.name);
+    if (it == ModeCases().end()) {
+      continue;
+    }
+    if (groups.find(it->second.first) == groups.end()) {
+      order.push_back(it->second.first);
+    }
+    groups[it->second.first][it->second.second] = &result;
+  }
+  if (order.empty()) {
+    return;
+  }
+  char line[256];
+  std::snprintf(line,
+                sizeof(line),
+                "%-28s %-16s %12s %10s %14s",
+                "op/shape",
+                "mode",
+                "ns/call",
+                "vs default",
+                "allocs/call");
+  std::cout << "\n" << line << std::endl;
+  for (const std::string& group : order) {
+    auto& by_mode = groups[group];
+    auto base = by_mode.find(Mode::kDefault);
+    for (auto& entry : by_mode) {
+      BenchResult* result = entry.second;
+      double ns = result->median_ns / result->items_per_iter;
+      double ratio = base != by_mode.end() && base->second->median_ns > 0
+                         ? result->median_ns / base->second->median_ns
+                         : 0.0;
+      result->counters["time_vs_default"] = ratio;
+      auto allocs = result->counters.find("allocs_per_item");
+      std::snprintf(line,
+                    sizeof(line),
+                    "%-28s %-16s %12.1f %10.2f %14.2f",
+                    group.c_str(),
+                    ModeName(entry.first),
+                    ns,
+                    ratio,
+                    allocs == result->counters.end() ? 0.0 : allocs->second);
+      std::cout << line << std::endl;
+    }
+  }
+}
+
+}  // namespace
+
+// Per-call latency of small-tensor ops in the default grad mode, on inputs
+// that require grad, under NoGradGuard and under InferenceMode, plus the
+// cost of entering and leaving each guard. On torch the guards remove the
+// autograd graph and version counter work; if the compat layer ignores
+// them, the guarded cases cost the same as (or more than) default, and
+// requires_grad shows what the bookkeeping costs when it is paid.
+BENCH_SUITE(GradModeBench) {
+  const std::vector<std::vector<int64_t>> shapes = {{16}, {4, 8}, {32, 32}};
+  const std::vector<Mode> modes = {Mode::kDefault,
+                                   Mode::kRequiresGrad,
+                                   Mode::kNoGrad,
+                                   Mode::kInferenceMode};
+  for (const auto& op : SmallOps()) {
+    for (const std::vector<int64_t>& shape : shapes) {
+      std::string shape_name;
+      for (int64_t dim : shape) {
+        shape_name += (shape_name.empty() ? "" : "x") + std::to_string(dim);
+      }
+      for (Mode mode : modes) {
+        std::string name = CaseName({op.first, shape_name, ModeName(mode)});
+        ModeCases()[name] = {CaseName({op.first, shape_name}), mode};
+        SmallOp fn = op.second;
+        RegisterBenchmark(
+            name,
+            [shape, mode, fn]() -> BenchBody {
+              at::Tensor input = MakeInput(shape, at::kFloat);
+              if (mode == Mode::kRequiresGrad) {
+                input.set_requires_grad(true);
+              }
+              return [input, mode, fn]() {
+                RunUnder(mode, [&]() {
+                  for (int64_t i = 0; i < kCallsPerIter; ++i) {
+                    DoNotOptimize(fn(input));
+                  }
+                });
+              };
+            },
+            0,
+            kCallsPerIter);
+      }
+    }
+  }
+
+  // Entering and leaving the guards alone.
+  RegisterBenchmark(
+      "guard/no_grad",
+      []() -> BenchBody {
+        return []() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            at::NoGradGuard guard;
+            ClobberMemory();
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+  RegisterBenchmark(
+      "guard/inference_mode",
+      []() -> BenchBody {
+        return []() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            c10::InferenceMode guard;
+            ClobberMemory();
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+  RegisterSummary(PrintModeSummary);
+}
+
+}  // namespace bench
+}  // namespace at
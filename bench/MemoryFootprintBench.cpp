@@ -0,0 +1,143 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/zeros.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+#include "bench_util.h"
+#include "benchmark.h"
+#include "proc_status.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Number of live tensors per case; MEMORY_FOOTPRINT_TENSORS overrides the
+// default of one million for quick runs.
+int64_t NumTensors() {
+  const char* env = std::getenv("MEMORY_FOOTPRINT_TENSORS");
+  int64_t n = env != nullptr ? std::atoll(env) : 0;
+  return n > 0 ? n : int64_t{1} << 20;
+}
+
+// Hands unused heap pages back to the OS, so that the RSS baseline of one
+// case does not depend on what the previous case freed.
+void TrimHeap() {
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
+
+// Creates num_tensors tensors with make(i), keeps them all alive, then
+// destroys them, and reports:
+//   heap_bytes_per_tensor     - bytes malloc'ed per tensor besides its data,
+//                               including the at::Tensor handle in a vector
+//   heap_allocs_per_tensor    - malloc calls per tensor
+//   rss_bytes_per_tensor      - resident memory growth per live tensor
+//   peak_rss_mb               - process peak RSS while they were alive
+//   rss_returned_pct          - share of that growth given back to the OS
+//                               right after destruction
+//   rss_returned_after_trim_pct - the same after malloc_trim(0)
+// prepare, if given, runs once in the case setup, outside the measurement.
+void RegisterFootprint(const std::string& name,
+                       int64_t data_bytes_per_tensor,
+                       const std::function<at::Tensor(int64_t)>& make,
+                       const std::function<void()>& prepare = nullptr) {
+  int64_t num_tensors = NumTensors();
+  RegisterBenchmark(
+      CaseName({"footprint", name}),
+      [make, prepare, num_tensors, data_bytes_per_tensor]() -> BenchBody {
+        if (prepare) {
+          prepare();
+        }
+        return [make, num_tensors, data_bytes_per_tensor]() {
+          TrimHeap();
+          bool peak_reset = test::ResetPeakRss();
+          int64_t rss_before_kb = test::ReadStatusKb("VmRSS");
+          test::AllocStats stats;
+          int64_t rss_live_kb = 0;
+          {
+            test::AllocScope scope;
+            std::vector<at::Tensor> tensors;
+            tensors.reserve(num_tensors);
+            for (int64_t i = 0; i < num_tensors; ++i) {
+              tensors.push_back(make(i));
+            }
+            stats = scope.Stats();
+            rss_live_kb = test::ReadStatusKb("VmRSS");
+          }
+          int64_t rss_after_kb = test::ReadStatusKb("VmRSS");
+          TrimHeap();
+          int64_t rss_trimmed_kb = test::ReadStatusKb("VmRSS");
+
+          double n = static_cast<double>(num_tensors);
+          double grown_kb = static_cast<double>(rss_live_kb - rss_before_kb);
+          ReportCounter("heap_bytes_per_tensor",
+                        stats.bytes / n - data_bytes_per_tensor);
+          ReportCounter("heap_allocs_per_tensor", stats.allocs / n);
+          ReportCounter("rss_bytes_per_tensor", grown_kb * 1024 / n);
+          if (peak_reset) {
+            ReportCounter("peak_rss_mb", test::ReadStatusKb("VmHWM") / 1024.0);
+          }
+          if (grown_kb > 0) {
+            ReportCounter("rss_returned_pct",
+                          (rss_live_kb - rss_after_kb) / grown_kb * 100);
+            ReportCounter("rss_returned_after_trim_pct",
+                          (rss_live_kb - rss_trimmed_kb) / grown_kb * 100);
+          }
+        };
+      },
+      0,
+      num_tensors);
+}
+
+}  // namespace
+
+// Memory cost of keeping millions of tiny tensors alive. The data of these
+// tensors is a few bytes, so heap_bytes_per_tensor is dominated by the
+// tensor impl, storage and allocation holder objects of each backend.
+// ns_per_item is the cost of creating plus destroying one tensor.
+BENCH_SUITE(MemoryFootprintBench) {
+  RegisterFootprint("scalar", 4, [](int64_t) {
+    return at::zeros({}, at::kFloat);
+  });
+  RegisterFootprint("1d_4", 16, [](int64_t) {
+    return at::zeros({4}, at::kFloat);
+  });
+  RegisterFootprint("3d_2x2x2", 32, [](int64_t) {
+    return at::zeros({2, 2, 2}, at::kFloat);
+  });
+
+  // Views of one shared base: no data is allocated per tensor.
+  auto base = std::make_shared<at::Tensor>(at::zeros({1024}, at::kFloat));
+  RegisterFootprint("view_reshape", 0, [base](int64_t) {
+    return base->reshape({32, 32});
+  });
+  RegisterFootprint("view_slice", 0, [base](int64_t i) {
+    int64_t start = i % 1000;
+    return base->slice(0, start, start + 8);
+  });
+
+  // from_blob wrappers over an external buffer, 4 floats per tensor.
+  auto buffer = std::make_shared<std::vector<float>>();
+  RegisterFootprint(
+      "from_blob",
+      0,
+      [buffer](int64_t i) {
+        return at::from_blob(buffer->data() + i * 4, {4}, at::kFloat);
+      },
+      [buffer]() { buffer->resize(NumTensors() * 4); });
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,353 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/sum.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+#include "proc_status.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+int64_t PageSize() {
+  long page = sysconf(_SC_PAGESIZE);
+  return page > 0 ? page : 4096;
+}
+
+// Largest file to ingest. MMAP_BENCH_MAX_BYTES overrides the default of
+// 4GB capped at a quarter of the physical memory, since read_then_copy
+// holds two copies of the file next to its page cache.
+int64_t MaxBytes() {
+  const char* env = std::getenv("MMAP_BENCH_MAX_BYTES");
+  if (env != nullptr && std::atoll(env) > 0) {
+    return std::atoll(env);
+  }
+  int64_t physical =
+      static_cast<int64_t>(sysconf(_SC_PHYS_PAGES)) * PageSize();
+  int64_t limit = int64_t{4} << 30;
+  return physical > 0 ? std::min(limit, physical / 4) : limit;
+}
+
+// Directory of the data files, MMAP_BENCH_DIR or else TMPDIR or /tmp.
+std::string DataDir() {
+  const char* dir = std::getenv("MMAP_BENCH_DIR");
+  if (dir == nullptr) {
+    dir = std::getenv("TMPDIR");
+  }
+  return dir != nullptr ? dir : "/tmp";
+}
+
+int64_t FreeBytes(const std::string& dir) {
+  struct statvfs fs;
+  if (statvfs(dir.c_str(), &fs) != 0) {
+    return -1;
+  }
+  return static_cast<int64_t>(fs.f_bavail) * static_cast<int64_t>(fs.f_frsize);
+}
+
+// A file of float32 values i % 1000, removed on destruction. Writing it
+// leaves it in the page cache, so every mode reads the same cached pages
+// and the comparison is about copies, not the disk.
+class DataFile {
+ public:
+  explicit DataFile(int64_t bytes) : bytes_(bytes) {
+    path_ = DataDir() + "/mmap_ingest_XXXXXX";
+    int fd = mkstemp(&path_[0]);
+    if (fd < 0) {
+      throw std::runtime_error("cannot create a file in " + DataDir());
+    }
+    std::vector<float> chunk((int64_t{64} << 20) / sizeof(float));
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      chunk[i] = static_cast<float>(i % 1000);
+    }
+    int64_t chunk_bytes = static_cast<int64_t>(chunk.size() * sizeof(float));
+    for (int64_t offset = 0; offset < bytes;) {
+      int64_t n = std::min(chunk_bytes, bytes - offset);
+      ssize_t written = write(fd, chunk.data(), n);
+      if (written <= 0) {
+        close(fd);
+        unlink(path_.c_str());
+        throw std::runtime_error("cannot write " + path_);
+      }
+      offset += written;
+    }
+    close(fd);
+  }
+
+  ~DataFile() { unlink(path_.c_str()); }
+
+  const std::string& path() const { return path_; }
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  std::string path_;
+  int64_t bytes_;
+};
+
+// Cases run size by size, so only the file of the current size is kept;
+// it is written once and shared by all cases of that size.
+std::shared_ptr<DataFile> GetDataFile(int64_t bytes) {
+  static std::shared_ptr<DataFile> current;
+  if (!current || current->bytes() != bytes) {
+    current.reset();
+    current = std::make_shared<DataFile>(bytes);
+  }
+  return current;
+}
+
+// Read-only descriptor closed on scope exit, so a failed read or
+// allocation in Ingest does not leak it.
+class ReadOnlyFd {
+ public:
+  explicit ReadOnlyFd(const std::string& path)
+      : fd_(open(path.c_str(), O_RDONLY)) {
+    if (fd_ < 0) {
+      throw std::runtime_error("cannot open " + path);
+    }
+  }
+  ~ReadOnlyFd() { close(fd_); }
+
+  ReadOnlyFd(const ReadOnlyFd&) = delete;
+  ReadOnlyFd& operator=(const ReadOnlyFd&) = delete;
+
+  int get() const { return fd_; }
+
+ private:
+  int fd_;
+};
+
+void ReadFully(int fd, char* data, int64_t bytes) {
+  for (int64_t offset = 0; offset < bytes;) {
+    ssize_t n = pread(fd, data + offset, bytes - offset, offset);
+    if (n <= 0) {
+      throw std::runtime_error("short read");
+    }
+    offset += n;
+  }
+}
+
+enum class Mode { kMmap, kMmapPopulate, kReadIntoEmpty, kReadThenCopy };
+
+const char* ModeName(Mode mode) {
+  switch (mode) {
+    case Mode::kMmap:
+      return "mmap_from_blob";
+    case Mode::kMmapPopulate:
+      return "mmap_populate_from_blob";
+    case Mode::kReadIntoEmpty:
+      return "read_into_empty";
+    case Mode::kReadThenCopy:
+      return "read_then_copy";
+  }
+  return "unknown";
+}
+
+// Times the deleter ran, for the deleter_calls counter.
+int64_t& UnmapCalls() {
+  static int64_t calls = 0;
+  return calls;
+}
+
+// Turns the file into a float32 tensor:
+//   mmap_from_blob          - private mapping wrapped by from_blob, with a
+//                             deleter that unmaps it; no copy at all
+//   mmap_populate_from_blob - the same with MAP_POPULATE, paying the page
+//                             table setup up front instead of on access
+//   read_into_empty         - one copy, read() straight into at::empty
+//   read_then_copy          - two copies, read() into a heap buffer that is
+//                             then copied into a tensor with clone()
+at::Tensor Ingest(Mode mode, const DataFile& file) {
+  int64_t bytes = file.bytes();
+  int64_t numel = bytes / static_cast<int64_t>(sizeof(float));
+  at::TensorOptions options = at::TensorOptions().dtype(at::kFloat);
+  ReadOnlyFd fd(file.path());
+  at::Tensor tensor;
+  if (mode == Mode::kMmap || mode == Mode::kMmapPopulate) {
+    int flags = MAP_PRIVATE;
+    if (mode == Mode::kMmapPopulate) {
+      flags |= MAP_POPULATE;
+    }
+    // The mapping stays valid after fd is closed.
+    void* data =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, fd.get(), 0);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("cannot map " + file.path());
+    }
+    return at::from_blob(
+        data,
+        {numel},
+        [bytes](void* ptr) {
+          ++UnmapCalls();
+          munmap(ptr, bytes);
+        },
+        options);
+  }
+  if (mode == Mode::kReadIntoEmpty) {
+    tensor = at::empty({numel}, options);
+    ReadFully(fd.get(), static_cast<char*>(tensor.data_ptr()), bytes);
+  } else {
+    std::unique_ptr<char[]> buffer(new char[bytes]);
+    ReadFully(fd.get(), buffer.get(), bytes);
+    tensor = at::from_blob(buffer.get(), {numel}, options).clone();
+  }
+  return tensor;
+}
+
+// Anonymous memory (i.e. copies of the file) held while one ingested
+// tensor is alive, and for the mmap modes whether the deleter waited for a
+// reshape/transpose view that outlived the tensor and then ran exactly once.
+void ReportIngestChecks(Mode mode, const DataFile& file) {
+  int64_t anon_before_kb = test::ReadStatusKb("RssAnon");
+  int64_t calls_before = UnmapCalls();
+  int64_t anon_live_kb = -1;
+  {
+    at::Tensor view;
+    {
+      at::Tensor tensor = Ingest(mode, file);
+      DoNotOptimize(at::sum(tensor));
+      anon_live_kb = test::ReadStatusKb("RssAnon");
+      view = tensor.reshape({-1, 1024}).transpose(0, 1);
+    }
+    if (mode == Mode::kMmap || mode == Mode::kMmapPopulate) {
+      ReportCounter("deleter_ran_early",
+                    UnmapCalls() != calls_before ? 1 : 0);
+    }
+  }
+  if (anon_before_kb >= 0 && anon_live_kb >= 0) {
+    ReportCounter("anon_rss_mb", (anon_live_kb - anon_before_kb) / 1024.0);
+  }
+  if (mode == Mode::kMmap || mode == Mode::kMmapPopulate) {
+    ReportCounter("deleter_calls",
+                  static_cast<double>(UnmapCalls() - calls_before));
+  }
+}
+
+// Case name -> (phase/size group, mode), for the summary.
+std::map<std::string, std::pair<std::string, Mode>>& IngestCases() {
+  static std::map<std::string, std::pair<std::string, Mode>> cases;
+  return cases;
+}
+
+// Prints every mode's time relative to read_then_copy of the same phase and
+// size.
+void PrintIngestSummary(std::vector<BenchResult>* results) {
+  std::map<std::string, std::map<Mode, BenchResult*>> groups;
+  std::vector<std::string> order;
+  for (BenchResult& result : *results) {
+    auto it = IngestCases().find(result.name);
+    if (it == IngestCases().end()) {
+      continue;
+    }
+    if (groups.find(it->second.first) == groups.end()) {
+      order.push_back(it->second.first);
+    }
+    groups[it->second.first][it->second.second] = &result;
+  }
+  if (order.empty()) {
+    return;
+  }
+  char line[256];
+  std::snprintf(line,
+                sizeof(line),
+                "%-16s %-24s %12s %14s %12s",
+                "phase/size",
+                "mode",
+                "ms",
+                "vs read+copy",
+                "anon MB");
+  std::cout << "\n" << line << std::endl;
+  for (const std::string& group : order) {
+    auto& by_mode = groups[group];
+    auto base = by_mode.find(Mode::kReadThenCopy);
+    for (auto& entry : by_mode) {
+      BenchResult* result = entry.second;
+      double speedup = base != by_mode.end() && result->median_ns > 0
+                           ? base->second->median_ns / result->median_ns
+                           : 0.0;
+      result->counters["speedup_vs_read_then_copy"] = speedup;
+      auto anon = result->counters.find("anon_rss_mb");
+      std::snprintf(line,
+                    sizeof(line),
+                    "%-16s %-24s %12.3f %14.2f %12.1f",
+                    group.c_str(),
+                    ModeName(entry.first),
+                    result->median_ns / 1e6,
+                    speedup,
+                    anon == result->counters.end() ? 0.0 : anon->second);
+      std::cout << line << std::endl;
+    }
+  }
+}
+
+}  // namespace
+
+// Ingesting a float32 file of 64MB up to several GB (capped by
+// MMAP_BENCH_MAX_BYTES, written to MMAP_BENCH_DIR) by wrapping a mapping
+// with from_blob and an munmap deleter, against reading it into a tensor.
+// "ingest" stops at a usable tensor; "ingest_sum" adds one full pass, so
+// the mapping pays its page faults. On both backends the mmap modes should
+// show anon_rss_mb near 0 and deleter_calls 1; anything else means
+// from_blob copied the data or mismanaged the deleter.
+BENCH_SUITE(MmapIngestBench) {
+  int64_t max_bytes = MaxBytes();
+  int64_t free_bytes = FreeBytes(DataDir());
+  const std::vector<Mode> modes = {Mode::kMmap,
+                                   Mode::kMmapPopulate,
+                                   Mode::kReadIntoEmpty,
+                                   Mode::kReadThenCopy};
+  for (int64_t bytes :
+       {int64_t{64} << 20, int64_t{1} << 30, int64_t{4} << 30}) {
+    if (bytes > max_bytes) {
+      continue;
+    }
+    if (free_bytes >= 0 && bytes > free_bytes / 2) {
+      std::cerr << "MmapIngestBench: skipping " << (bytes >> 20)
+                << "MB, not enough space in " << DataDir() << std::endl;
+      continue;
+    }
+    std::string size = std::to_string(bytes >> 20) + "MB";
+    for (bool with_sum : {false, true}) {
+      const char* phase = with_sum ? "ingest_sum" : "ingest";
+      for (Mode mode : modes) {
+        std::string name = CaseName({phase, ModeName(mode), size});
+        IngestCases()[name] = {CaseName({phase, size}), mode};
+        RegisterBenchmark(
+            name,
+            [bytes, mode, with_sum]() -> BenchBody {
+              std::shared_ptr<DataFile> file = GetDataFile(bytes);
+              ReportIngestChecks(mode, *file);
+              return [file, mode, with_sum]() {
+                at::Tensor tensor = Ingest(mode, *file);
+                if (with_sum) {
+                  DoNotOptimize(at::sum(tensor));
+                } else {
+                  DoNotOptimize(tensor.data_ptr());
+                }
+              };
+            },
+            bytes);
+      }
+    }
+  }
+  RegisterSummary(PrintIngestSummary);
+}
+
+}  // namespace bench
+}  // namespace at
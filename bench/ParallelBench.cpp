@@ -0,0 +1,194 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+constexpr int64_t kLargeNumel = int64_t{16} << 20;
+// Calls per iteration of the per-call overhead cases.
+constexpr int64_t kCallsPerIter = 100;
+
+// Distinct kernel thread ids that ran a chunk of 100 small parallel_for
+// calls. A pool reuses its workers, so this stays at most threads + 1; an
+// implementation that spawns threads per call sees new ids every call.
+double DistinctThreadIds(int64_t range) {
+  std::mutex mutex;
+  std::set<int64_t> tids;
+  for (int call = 0; call < 100; ++call) {
+    at::parallel_for(0, range, 1, [&](int64_t, int64_t) {
+      std::lock_guard<std::mutex> lock(mutex);
+      tids.insert(static_cast<int64_t>(syscall(SYS_gettid)));
+    });
+  }
+  return static_cast<double>(tids.size());
+}
+
+std::string ThreadsTag(int threads) {
+  return "threads" + std::to_string(threads);
+}
+
+void RegisterOverheadCases(int threads) {
+  // Range within the grain size: must run inline on the caller.
+  RegisterBenchmark(
+      CaseName({"parallel_for", "inline", ThreadsTag(threads)}),
+      [threads]() -> BenchBody {
+        at::set_num_threads(threads);
+        return []() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            at::parallel_for(0, 1, 1, [](int64_t b, int64_t e) {
+              DoNotOptimize(b);
+              DoNotOptimize(e);
+            });
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+  // One tiny work item per thread: the cost of waking the pool.
+  RegisterBenchmark(
+      CaseName({"parallel_for", "tiny", ThreadsTag(threads)}),
+      [threads]() -> BenchBody {
+        at::set_num_threads(threads);
+        ReportCounter("distinct_tids_per_100_calls",
+                      DistinctThreadIds(threads));
+        return [threads]() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            at::parallel_for(0, threads, 1, [](int64_t b, int64_t e) {
+              DoNotOptimize(b);
+              DoNotOptimize(e);
+            });
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+}
+
+void RegisterScalingCases(int threads) {
+  // out = 2 * in, bandwidth bound.
+  RegisterBenchmark(
+      CaseName({"parallel_for", "scale_f32", "16M", ThreadsTag(threads)}),
+      [threads]() -> BenchBody {
+        at::set_num_threads(threads);
+        at::Tensor input = MakeInput({kLargeNumel}, at::kFloat);
+        at::Tensor output = at::empty({kLargeNumel}, at::kFloat);
+        return [input, output]() {
+          const float* in = input.data_ptr<float>();
+          float* out = output.data_ptr<float>();
+          at::parallel_for(0, kLargeNumel, 32768, [&](int64_t b, int64_t e) {
+            for (int64_t i = b; i < e; ++i) {
+              out[i] = 2.0f * in[i];
+            }
+          });
+          ClobberMemory();
+        };
+      },
+      2 * kLargeNumel * DtypeSize(at::kFloat));
+  RegisterBenchmark(
+      CaseName({"parallel_reduce", "sum_f32", "16M", ThreadsTag(threads)}),
+      [threads]() -> BenchBody {
+        at::set_num_threads(threads);
+        at::Tensor input = MakeInput({kLargeNumel}, at::kFloat);
+        return [input]() {
+          const float* in = input.data_ptr<float>();
+          double sum = at::parallel_reduce(
+              0,
+              kLargeNumel,
+              32768,
+              0.0,
+              [&](int64_t b, int64_t e, double ident) {
+                double partial = ident;
+                for (int64_t i = b; i < e; ++i) {
+                  partial += in[i];
+                }
+                return partial;
+              },
+              [](double a, double b) { return a + b; });
+          DoNotOptimize(sum);
+        };
+      },
+      kLargeNumel * DtypeSize(at::kFloat));
+  // 64 outer items, each running an inner parallel_for that should execute
+  // inline on the outer worker.
+  RegisterBenchmark(
+      CaseName({"parallel_for", "nested", "64x64K", ThreadsTag(threads)}),
+      [threads]() -> BenchBody {
+        at::set_num_threads(threads);
+        at::Tensor output = at::empty({64, 65536}, at::kFloat);
+        return [output]() {
+          float* out = output.data_ptr<float>();
+          at::parallel_for(0, 64, 1, [&](int64_t ob, int64_t oe) {
+            for (int64_t o = ob; o < oe; ++o) {
+              float* row = out + o * 65536;
+              at::parallel_for(0, 65536, 4096, [&](int64_t b, int64_t e) {
+                for (int64_t i = b; i < e; ++i) {
+                  row[i] = static_cast<float>(i);
+                }
+              });
+            }
+          });
+          ClobberMemory();
+        };
+      },
+      64 * 65536 * DtypeSize(at::kFloat));
+}
+
+}  // namespace
+
+// The intra-op threading API on its own, without any tensor kernel:
+// per-call overhead of inline and tiny parallel_for calls, bandwidth-bound
+// parallel_for and parallel_reduce loops and nested parallel_for at 1..N
+// threads, and a grain size sweep at all threads. A per-call cost of tens
+// of microseconds, no speedup in the scaling summary or a growing
+// distinct_tids_per_100_calls means kernels built on the compat
+// parallel_for lose their parallelism.
+BENCH_SUITE(ParallelBench) {
+  for (int threads : ThreadSweep()) {
+    RegisterOverheadCases(threads);
+    RegisterScalingCases(threads);
+  }
+  int max_threads = ThreadSweep().back();
+  for (int64_t grain : {int64_t{1} << 6,
+                        int64_t{1} << 10,
+                        int64_t{1} << 14,
+                        int64_t{1} << 18,
+                        kLargeNumel}) {
+    RegisterBenchmark(
+        CaseName({"parallel_for",
+                  "grain" + std::to_string(grain),
+                  "scale_f32",
+                  "16M"}),
+        [grain, max_threads]() -> BenchBody {
+          at::set_num_threads(max_threads);
+          at::Tensor input = MakeInput({kLargeNumel}, at::kFloat);
+          at::Tensor output = at::empty({kLargeNumel}, at::kFloat);
+          return [input, output, grain]() {
+            const float* in = input.data_ptr<float>();
+            float* out = output.data_ptr<float>();
+            at::parallel_for(0, kLargeNumel, grain, [&](int64_t b, int64_t e) {
+              for (int64_t i = b; i < e; ++i) {
+                out[i] = 2.0f * in[i];
+              }
+            });
+            ClobberMemory();
+          };
+        },
+        2 * kLargeNumel * DtypeSize(at::kFloat));
+  }
+  RegisterThreadScalingSummary();
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,244 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Input footprints from L1-resident up to DRAM-resident.
+struct Footprint {
+  const char* label;
+  int64_t bytes;
+};
+
+const std::vector<Footprint>& Footprints() {
+  static const std::vector<Footprint> footprints = {
+      {"16KB", 16 << 10},
+      {"256KB", 256 << 10},
+      {"8MB", 8 << 20},
+      {"64MB", 64 << 20}};
+  return footprints;
+}
+
+// Inner dim of the 2-D inputs; footprints are multiples of it.
+constexpr int64_t kCols = 64;
+
+// Case name -> footprint label, for every case compared against STREAM.
+std::map<std::string, std::string>& OpFootprints() {
+  static std::map<std::string, std::string> footprints;
+  return footprints;
+}
+
+// Footprint label -> name of the STREAM triad case of that footprint.
+std::map<std::string, std::string>& StreamCases() {
+  static std::map<std::string, std::string> cases;
+  return cases;
+}
+
+// A float32 tensor with numel elements in the given layout:
+//   contiguous - [numel / kCols, kCols]
+//   transposed - the transpose of a contiguous [kCols, numel / kCols]
+//   sliced     - the first kCols columns of a [numel / kCols, 2 * kCols]
+at::Tensor MakeLayout(const std::string& layout, int64_t numel) {
+  int64_t rows = numel / kCols;
+  if (layout == "transposed") {
+    return MakeInput({kCols, rows}, at::kFloat).transpose(0, 1);
+  }
+  if (layout == "sliced") {
+    return MakeInput({rows, 2 * kCols}, at::kFloat).narrow(1, 0, kCols);
+  }
+  return MakeInput({rows, kCols}, at::kFloat);
+}
+
+struct RooflineOp {
+  const char* name;
+  // Bytes read plus bytes written per float32 input element.
+  int64_t bytes_per_elem;
+  std::function<void(at::Tensor&)> run;
+};
+
+const std::vector<RooflineOp>& RooflineOps() {
+  static const std::vector<RooflineOp> ops = {
+      {"abs", 8, [](at::Tensor& t) { DoNotOptimize(at::abs(t)); }},
+      {"fill_", 4, [](at::Tensor& t) { DoNotOptimize(t.fill_(1.5f)); }},
+      {"zero_", 4, [](at::Tensor& t) { DoNotOptimize(t.zero_()); }},
+      {"toType_float64",
+       12,
+       [](at::Tensor& t) { DoNotOptimize(t.toType(at::kDouble)); }}};
+  return ops;
+}
+
+// STREAM copy / scale / triad over plain float arrays of numel elements.
+// These are single-threaded loops, so every case compared against them
+// runs the ATen op at one thread as well.
+void RegisterStream(const Footprint& footprint) {
+  int64_t numel = footprint.bytes / static_cast<int64_t>(sizeof(float));
+  struct Arrays {
+    std::vector<float> a, b, c;
+  };
+  auto make_arrays = [numel]() {
+    auto arrays = std::make_shared<Arrays>();
+    arrays->a.assign(numel, 1.0f);
+    arrays->b.assign(numel, 2.0f);
+    arrays->c.assign(numel, 0.0f);
+    return arrays;
+  };
+  int64_t array_bytes = footprint.bytes;
+
+  RegisterBenchmark(
+      CaseName({"stream", "copy", footprint.label}),
+      [make_arrays, numel]() -> BenchBody {
+        auto arrays = make_arrays();
+        return [arrays, numel]() {
+          const float* a = arrays->a.data();
+          float* c = arrays->c.data();
+          for (int64_t i = 0; i < numel; ++i) {
+            c[i] = a[i];
+          }
+          ClobberMemory();
+        };
+      },
+      2 * array_bytes,
+      numel);
+  RegisterBenchmark(
+      CaseName({"stream", "scale", footprint.label}),
+      [make_arrays, numel]() -> BenchBody {
+        auto arrays = make_arrays();
+        return [arrays, numel]() {
+          const float* c = arrays->c.data();
+          float* b = arrays->b.data();
+          for (int64_t i = 0; i < numel; ++i) {
+            b[i] = 3.0f * c[i];
+          }
+          ClobberMemory();
+        };
+      },
+      2 * array_bytes,
+      numel);
+  std::string triad = CaseName({"stream", "triad", footprint.label});
+  StreamCases()[footprint.label] = triad;
+  RegisterBenchmark(
+      triad,
+      [make_arrays, numel]() -> BenchBody {
+        auto arrays = make_arrays();
+        return [arrays, numel]() {
+          const float* b = arrays->b.data();
+          const float* c = arrays->c.data();
+          float* a = arrays->a.data();
+          for (int64_t i = 0; i < numel; ++i) {
+            a[i] = b[i] + 3.0f * c[i];
+          }
+          ClobberMemory();
+        };
+      },
+      3 * array_bytes,
+      numel);
+}
+
+// Adds pct_of_stream (achieved GB/s over STREAM triad GB/s at the same
+// footprint) to every op case and prints the roofline table.
+void ReportRoofline(std::vector<BenchResult>* results) {
+  std::map<std::string, double> stream_gbps;
+  for (const BenchResult& result : *results) {
+    for (const auto& stream : StreamCases()) {
+      if (stream.second == result.name) {
+        stream_gbps[stream.first] = GigabytesPerSecond(result);
+      }
+    }
+  }
+
+  char line[256];
+  std::snprintf(line,
+                sizeof(line),
+                "%-44s %10s %12s %10s",
+                "case",
+                "GB/s",
+                "STREAM GB/s",
+                "% STREAM");
+  std::cout << "\n" << line << std::endl;
+  for (BenchResult& result : *results) {
+    auto it = OpFootprints().find(result.name);
+    if (it == OpFootprints().end() || stream_gbps.count(it->second) == 0) {
+      continue;
+    }
+    double stream = stream_gbps[it->second];
+    double achieved = GigabytesPerSecond(result);
+    double pct = stream > 0 ? achieved / stream * 100 : 0;
+    result.counters["pct_of_stream"] = pct;
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-44s %10.2f %12.2f %9.1f%%",
+                  result.name.c_str(),
+                  achieved,
+                  stream,
+                  pct);
+    std::cout << line << std::endl;
+  }
+}
+
+}  // namespace
+
+// Elementwise kernels against the memory roofline: abs, fill_, zero_ and
+// toType on contiguous, transposed and sliced inputs from L1 to DRAM, next
+// to a STREAM probe on the same machine, all at one thread. The tail cases
+// use element counts just around 1<<20, large enough that the call overhead
+// vanishes; a slow remainder path (e.g. a scalar fallback for the whole
+// tensor when numel is not a multiple of the SIMD width) shows as a jump in
+// ns_per_item between n1048576 and its odd neighbours.
+BENCH_SUITE(RooflineBench) {
+  for (const Footprint& footprint : Footprints()) {
+    RegisterStream(footprint);
+    int64_t numel = footprint.bytes / static_cast<int64_t>(sizeof(float));
+    for (const RooflineOp& op : RooflineOps()) {
+      for (const char* layout : {"contiguous", "transposed", "sliced"}) {
+        std::string name =
+            CaseName({"roofline", op.name, layout, footprint.label});
+        OpFootprints()[name] = footprint.label;
+        std::function<void(at::Tensor&)> run = op.run;
+        std::string layout_name = layout;
+        RegisterBenchmark(
+            name,
+            [run, layout_name, numel]() -> BenchBody {
+              at::set_num_threads(1);
+              at::Tensor input = MakeLayout(layout_name, numel);
+              return [run, input]() mutable { run(input); };
+            },
+            op.bytes_per_elem * numel,
+            numel);
+      }
+    }
+  }
+
+  for (const RooflineOp& op : RooflineOps()) {
+    for (int64_t k : {0, -1, 1, -3, 3, 7}) {
+      int64_t numel = (int64_t{1} << 20) + k;
+      std::function<void(at::Tensor&)> run = op.run;
+      RegisterBenchmark(
+          CaseName({"tail", op.name, "n" + std::to_string(numel)}),
+          [run, numel]() -> BenchBody {
+            at::set_num_threads(1);
+            at::Tensor input = MakeInput({numel}, at::kFloat);
+            return [run, input]() mutable { run(input); };
+          },
+          op.bytes_per_elem * numel,
+          numel);
+    }
+  }
+  RegisterSummary(ReportRoofline);
+}
+
+}  // namespace bench
+}  // namespace at
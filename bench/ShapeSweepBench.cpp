@@ -0,0 +1,409 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+int64_t EnvInt(const char* name, int64_t default_value) {
+  const char* env = std::getenv(name);
+  int64_t value = env != nullptr ? std::atoll(env) : 0;
+  return value > 0 ? value : default_value;
+}
+
+// Case i of a sweep only depends on the seed and i, so a case keeps its
+// name and inputs when SHAPE_SWEEP_CASES changes.
+class CaseRng {
+ public:
+  CaseRng(uint64_t seed, int64_t index)
+      : engine_(seed * 1000003u + static_cast<uint64_t>(index)) {}
+
+  // Uniform in [0, n). std::uniform_int_distribution is not specified
+  // bit-exactly, so it could differ between the two binaries' toolchains.
+  int64_t Below(int64_t n) {
+    return static_cast<int64_t>(engine_() % static_cast<uint64_t>(n));
+  }
+
+  template <typename T>
+  const T& Pick(const std::vector<T>& values) {
+    return values[Below(static_cast<int64_t>(values.size()))];
+  }
+
+ private:
+  std::mt19937_64 engine_;
+};
+
+// Dim sizes that stress the tail loops of vectorized kernels: primes and
+// odd sizes next to powers of two, plus size-1 dims.
+int64_t SampleDim(CaseRng* rng) {
+  static const std::vector<int64_t> primes = {
+      2, 3, 5, 7, 13, 31, 61, 127, 251, 509, 1021, 4093};
+  static const std::vector<int64_t> odd = {9, 15, 33, 63, 255, 1023, 4095};
+  static const std::vector<int64_t> pow2 = {8, 16, 64, 256, 1024, 4096};
+  int64_t kind = rng->Below(10);
+  if (kind < 2) {
+    return 1;
+  }
+  if (kind < 5) {
+    return rng->Pick(primes);
+  }
+  if (kind < 8) {
+    return rng->Pick(odd);
+  }
+  return rng->Pick(pow2);
+}
+
+std::vector<int64_t> SampleShape(CaseRng* rng, int64_t max_numel) {
+  std::vector<int64_t> shape(rng->Below(5));
+  for (int64_t& dim : shape) {
+    dim = SampleDim(rng);
+  }
+  // Shrink the largest dim until the tensor fits.
+  while (true) {
+    int64_t numel = 1;
+    size_t largest = 0;
+    for (size_t i = 0; i < shape.size(); ++i) {
+      numel *= shape[i];
+      if (shape[i] > shape[largest]) {
+        largest = i;
+      }
+    }
+    if (numel <= max_numel) {
+      break;
+    }
+    shape[largest] = 1 + rng->Below(31);
+  }
+  // A 0-element tensor in roughly one case out of twenty.
+  if (!shape.empty() && rng->Below(20) == 0) {
+    shape[rng->Below(static_cast<int64_t>(shape.size()))] = 0;
+  }
+  return shape;
+}
+
+std::string ShapeName(const std::vector<int64_t>& shape) {
+  if (shape.empty()) {
+    return "scalar";
+  }
+  std::string name;
+  for (int64_t dim : shape) {
+    name += (name.empty() ? "" : "x") + std::to_string(dim);
+  }
+  return name;
+}
+
+int64_t Numel(const std::vector<int64_t>& shape) {
+  int64_t numel = 1;
+  for (int64_t dim : shape) {
+    numel *= dim;
+  }
+  return numel;
+}
+
+enum class Op {
+  kAbs,
+  kSum,
+  kSumDim,
+  kCat,
+  kReshape,
+  kZeros,
+  kOnes,
+  kFull,
+  kEmpty,
+  kArange
+};
+
+const char* OpName(Op op) {
+  switch (op) {
+    case Op::kAbs:
+      return "abs";
+    case Op::kSum:
+      return "sum";
+    case Op::kSumDim:
+      return "sum_dim";
+    case Op::kCat:
+      return "cat";
+    case Op::kReshape:
+      return "reshape";
+    case Op::kZeros:
+      return "zeros";
+    case Op::kOnes:
+      return "ones";
+    case Op::kFull:
+      return "full";
+    case Op::kEmpty:
+      return "empty";
+    case Op::kArange:
+      return "arange";
+  }
+  return "unknown";
+}
+
+bool TakesInput(Op op) {
+  return op == Op::kAbs || op == Op::kSum || op == Op::kSumDim ||
+         op == Op::kCat || op == Op::kReshape;
+}
+
+// How the input of an op is laid out in memory.
+enum class Layout { kContiguous, kTransposed, kStepped, kBlob };
+
+// One generated case. Everything needed to rebuild it is in its name.
+struct SweepCase {
+  Op op = Op::kAbs;
+  at::ScalarType dtype = at::kFloat;
+  std::vector<int64_t> shape;
+  Layout layout = Layout::kContiguous;
+  // Element offset of a from_blob input from a 64-byte aligned address.
+  int64_t blob_offset = 0;
+  // Reduced dim of sum_dim, concatenated dim of cat.
+  int64_t dim = 0;
+  bool keepdim = false;
+  // Inputs of cat.
+  int64_t num_inputs = 1;
+};
+
+std::string LayoutName(const SweepCase& c) {
+  switch (c.layout) {
+    case Layout::kContiguous:
+      return "contig";
+    case Layout::kTransposed:
+      return "transposed";
+    case Layout::kStepped:
+      return "step2";
+    case Layout::kBlob:
+      return "blob+" + std::to_string(c.blob_offset);
+  }
+  return "unknown";
+}
+
+std::string SweepCaseName(int64_t index, const SweepCase& c) {
+  std::string op = OpName(c.op);
+  if (c.op == Op::kSumDim) {
+    op += "_d" + std::to_string(c.dim) + (c.keepdim ? "k" : "");
+  } else if (c.op == Op::kCat) {
+    op += std::to_string(c.num_inputs) + "_d" + std::to_string(c.dim);
+  }
+  return CaseName({"sweep",
+                   std::to_string(index),
+                   op,
+                   DtypeName(c.dtype),
+                   ShapeName(c.shape),
+                   TakesInput(c.op) ? LayoutName(c) : "new"});
+}
+
+SweepCase SampleCase(CaseRng* rng, int64_t max_numel) {
+  static const std::vector<Op> ops = {Op::kAbs,
+                                      Op::kSum,
+                                      Op::kSumDim,
+                                      Op::kCat,
+                                      Op::kReshape,
+                                      Op::kZeros,
+                                      Op::kOnes,
+                                      Op::kFull,
+                                      Op::kEmpty,
+                                      Op::kArange};
+  static const std::vector<at::ScalarType> dtypes = {
+      at::kFloat, at::kDouble, at::kInt, at::kLong};
+  SweepCase c;
+  c.op = rng->Pick(ops);
+  c.dtype = rng->Pick(dtypes);
+  c.shape = SampleShape(rng, max_numel);
+  if (c.op == Op::kArange) {
+    c.shape = {Numel(c.shape)};
+  }
+  if ((c.op == Op::kSumDim || c.op == Op::kCat) && c.shape.empty()) {
+    c.shape = {SampleDim(rng)};
+  }
+  if (!c.shape.empty()) {
+    c.dim = rng->Below(static_cast<int64_t>(c.shape.size()));
+  }
+  c.keepdim = rng->Below(2) == 1;
+  c.num_inputs = 2 + rng->Below(3);
+  if (TakesInput(c.op)) {
+    int64_t layout = rng->Below(4);
+    c.layout = static_cast<Layout>(layout);
+    if (c.layout == Layout::kTransposed && c.shape.size() < 2) {
+      c.layout = Layout::kContiguous;
+    }
+    if (c.layout == Layout::kStepped && c.shape.empty()) {
+      c.layout = Layout::kContiguous;
+    }
+    c.blob_offset = c.layout == Layout::kBlob ? 1 + rng->Below(15) : 0;
+  }
+  return c;
+}
+
+// Builds an input of c.shape with c.layout. from_blob inputs keep their
+// buffer alive through the returned holder.
+at::Tensor MakeSweepInput(const SweepCase& c,
+                          std::vector<std::shared_ptr<char[]>>* holders) {
+  switch (c.layout) {
+    case Layout::kContiguous:
+      return MakeInput(c.shape, c.dtype);
+    case Layout::kTransposed: {
+      std::vector<int64_t> reversed(c.shape.rbegin(), c.shape.rend());
+      std::vector<int64_t> perm;
+      for (int64_t i = static_cast<int64_t>(c.shape.size()) - 1; i >= 0; --i) {
+        perm.push_back(i);
+      }
+      return MakeInput(reversed, c.dtype).permute(perm);
+    }
+    case Layout::kStepped: {
+      std::vector<int64_t> doubled = c.shape;
+      doubled[0] *= 2;
+      return MakeInput(doubled, c.dtype).slice(0, 0, doubled[0], 2);
+    }
+    case Layout::kBlob: {
+      // Element aligned, so kernels stay well defined, but off the vector
+      // and cache line boundary by blob_offset elements.
+      int64_t element_size = DtypeSize(c.dtype);
+      int64_t bytes = Numel(c.shape) * element_size;
+      auto buffer = std::shared_ptr<char[]>(
+          new char[bytes + 16 * element_size + 64]);  // NOLINT
+      holders->push_back(buffer);
+      uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+      char* data = reinterpret_cast<char*>((base + 63) & ~uintptr_t{63}) +
+                   c.blob_offset * element_size;
+      if (bytes > 0) {
+        at::Tensor values = MakeInput(c.shape, c.dtype);
+        std::memcpy(data, values.data_ptr(), bytes);
+      }
+      return at::from_blob(data, c.shape, at::TensorOptions().dtype(c.dtype));
+    }
+  }
+  return at::Tensor();
+}
+
+BenchBody MakeSweepBody(const SweepCase& c) {
+  at::TensorOptions options = at::TensorOptions().dtype(c.dtype);
+  std::vector<int64_t> shape = c.shape;
+  std::vector<std::shared_ptr<char[]>> holders;
+  switch (c.op) {
+    case Op::kAbs: {
+      at::Tensor input = MakeSweepInput(c, &holders);
+      return [input, holders]() { DoNotOptimize(at::abs(input)); };
+    }
+    case Op::kSum: {
+      at::Tensor input = MakeSweepInput(c, &holders);
+      return [input, holders]() { DoNotOptimize(at::sum(input)); };
+    }
+    case Op::kSumDim: {
+      at::Tensor input = MakeSweepInput(c, &holders);
+      int64_t dim = c.dim;
+      bool keepdim = c.keepdim;
+      return [input, holders, dim, keepdim]() {
+        DoNotOptimize(at::sum(input, {dim}, keepdim));
+      };
+    }
+    case Op::kCat: {
+      std::vector<at::Tensor> inputs;
+      for (int64_t i = 0; i < c.num_inputs; ++i) {
+        inputs.push_back(MakeSweepInput(c, &holders));
+      }
+      int64_t dim = c.dim;
+      return [inputs, holders, dim]() { DoNotOptimize(at::cat(inputs, dim)); };
+    }
+    case Op::kReshape: {
+      at::Tensor input = MakeSweepInput(c, &holders);
+      int64_t numel = Numel(shape);
+      return [input, holders, numel]() {
+        DoNotOptimize(input.reshape({numel}));
+      };
+    }
+    case Op::kZeros:
+      return [shape, options]() { DoNotOptimize(at::zeros(shape, options)); };
+    case Op::kOnes:
+      return [shape, options]() { DoNotOptimize(at::ones(shape, options)); };
+    case Op::kFull:
+      return
+          [shape, options]() { DoNotOptimize(at::full(shape, 3, options)); };
+    case Op::kEmpty:
+      return [shape, options]() { DoNotOptimize(at::empty(shape, options)); };
+    case Op::kArange: {
+      int64_t end = shape[0];
+      return [end, options]() { DoNotOptimize(at::arange(end, options)); };
+    }
+  }
+  return []() {};
+}
+
+// Bytes read plus written by one call, to compare GB/s across cases.
+int64_t SweepBytes(const SweepCase& c) {
+  int64_t bytes = Numel(c.shape) * DtypeSize(c.dtype);
+  switch (c.op) {
+    case Op::kAbs:
+    case Op::kReshape:
+      return 2 * bytes;
+    case Op::kSum:
+    case Op::kSumDim:
+    case Op::kZeros:
+    case Op::kOnes:
+    case Op::kFull:
+    case Op::kArange:
+      return bytes;
+    case Op::kCat:
+      return 2 * c.num_inputs * bytes;
+    case Op::kEmpty:
+      return 0;
+  }
+  return 0;
+}
+
+}  // namespace
+
+// Seeded random cases over the ops of test/ops: ranks 0-4 with prime, odd,
+// power-of-two and size-1 dims, 0-element tensors, transposed and stepped
+// inputs, and from_blob inputs off the 64-byte boundary. Case names are
+// "sweep/<index>/<op>/<dtype>/<shape>/<layout>" and reproduce the case
+// together with the seed. A case the backend rejects is reported with the
+// "failed" counter instead of aborting the sweep.
+//
+// SHAPE_SWEEP_SEED (default 1), SHAPE_SWEEP_CASES (default 200) and
+// SHAPE_SWEEP_MAX_NUMEL (default 4M) control the sweep;
+// tools/shape_sweep.py runs it on both backends and flags the cliffs.
+BENCH_SUITE(ShapeSweepBench) {
+  uint64_t seed = static_cast<uint64_t>(EnvInt("SHAPE_SWEEP_SEED", 1));
+  int64_t num_cases = EnvInt("SHAPE_SWEEP_CASES", 200);
+  int64_t max_numel = EnvInt("SHAPE_SWEEP_MAX_NUMEL", int64_t{4} << 20);
+  for (int64_t index = 0; index < num_cases; ++index) {
+    CaseRng rng(seed, index);
+    SweepCase c = SampleCase(&rng, max_numel);
+    RegisterBenchmark(
+        SweepCaseName(index, c),
+        [c]() -> BenchBody {
+          try {
+            BenchBody body = MakeSweepBody(c);
+            body();
+            return body;
+          } catch (const std::exception&) {
+            ReportCounter("failed", 1);
+            return []() {};
+          }
+        },
+        SweepBytes(c));
+  }
+}
+
+}  // namespace bench
+}  // namespace at
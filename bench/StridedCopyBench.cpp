@@ -0,0 +1,128 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/reshape.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+std::string ShapeName(const std::vector<int64_t>& shape) {
+  std::string name;
+  for (int64_t dim : shape) {
+    name += (name.empty() ? "" : "x") + std::to_string(dim);
+  }
+  return name;
+}
+
+std::string PermName(const std::vector<int64_t>& perm) {
+  std::string name = "perm";
+  for (int64_t dim : perm) {
+    name += std::to_string(dim);
+  }
+  return name;
+}
+
+using MakeView = std::function<at::Tensor()>;
+
+// Registers contiguous() and a flattening reshape of the view built by
+// make_view. Both must copy; bytes count the strided read plus the
+// contiguous write.
+void RegisterCopies(const std::string& layout,
+                    const std::string& shape,
+                    int64_t numel,
+                    const MakeView& make_view) {
+  int64_t bytes = 2 * numel * DtypeSize(at::kFloat);
+  RegisterBenchmark(
+      CaseName({"contiguous", layout, shape}),
+      [make_view]() -> BenchBody {
+        at::Tensor view = make_view();
+        return [view]() { DoNotOptimize(view.contiguous()); };
+      },
+      bytes,
+      numel);
+  RegisterBenchmark(
+      CaseName({"reshape", layout, shape}),
+      [make_view, numel]() -> BenchBody {
+        at::Tensor view = make_view();
+        return [view, numel]() { DoNotOptimize(view.reshape({numel})); };
+      },
+      bytes,
+      numel);
+}
+
+void RegisterPermutation(const std::vector<int64_t>& shape,
+                         const std::vector<int64_t>& perm,
+                         const std::string& layout) {
+  int64_t numel = 1;
+  for (int64_t dim : shape) {
+    numel *= dim;
+  }
+  RegisterCopies(layout, ShapeName(shape), numel, [shape, perm]() {
+    return MakeInput(shape, at::kFloat).permute(perm);
+  });
+}
+
+}  // namespace
+
+// Materializing non-contiguous views: transposes, permutations of 3-D to
+// 5-D tensors (including NCHW <-> NHWC and NCDHW -> NDHWC), and sliced or
+// stepped views. Case names carry the shape of the source tensor before
+// the permutation or slice.
+BENCH_SUITE(StridedCopyBench) {
+  // 2-D transpose from L2-resident to DRAM-resident.
+  for (int64_t side : {256, 1024, 4096}) {
+    RegisterPermutation({side, side}, {1, 0}, "transpose2d");
+  }
+  // Every non-identity permutation of a 3-D tensor.
+  for (const std::vector<int64_t>& perm : std::vector<std::vector<int64_t>>{
+           {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}) {
+    for (int64_t side : {32, 128}) {
+      RegisterPermutation({side, side, side}, perm, PermName(perm));
+    }
+  }
+  // Image layouts.
+  for (const std::vector<int64_t>& nchw : std::vector<std::vector<int64_t>>{
+           {1, 3, 224, 224}, {8, 64, 56, 56}, {32, 256, 14, 14}}) {
+    RegisterPermutation(nchw, {0, 2, 3, 1}, "nchw_to_nhwc");
+    std::vector<int64_t> nhwc = {nchw[0], nchw[2], nchw[3], nchw[1]};
+    RegisterPermutation(nhwc, {0, 3, 1, 2}, "nhwc_to_nchw");
+  }
+  RegisterPermutation({2, 32, 16, 32, 32}, {0, 2, 3, 4, 1}, "ncdhw_to_ndhwc");
+
+  // Sliced views: contiguous rows with gaps between them, every other row,
+  // and every other element of a row.
+  for (int64_t rows : {256, 4096}) {
+    int64_t cols = 1024;
+    RegisterCopies("narrow_cols",
+                   ShapeName({rows, 2 * cols}),
+                   rows * cols,
+                   [rows, cols]() {
+                     return MakeInput({rows, 2 * cols}, at::kFloat)
+                         .narrow(1, 0, cols);
+                   });
+    RegisterCopies("step_rows",
+                   ShapeName({2 * rows, cols}),
+                   rows * cols,
+                   [rows, cols]() {
+                     return MakeInput({2 * rows, cols}, at::kFloat)
+                         .slice(0, 0, 2 * rows, 2);
+                   });
+    RegisterCopies("step_cols",
+                   ShapeName({rows, 2 * cols}),
+                   rows * cols,
+                   [rows, cols]() {
+                     return MakeInput({rows, 2 * cols}, at::kFloat)
+                         .slice(1, 0, 2 * cols, 2);
+                   });
+  }
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,106 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/ones.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Accessors cost a few ns, so every iteration makes this many calls and the
+// results are read from the ns_per_item / allocs_per_item counters.
+constexpr int64_t kCallsPerIter = 1000;
+
+std::string ShapeName(const std::vector<int64_t>& shape) {
+  std::string name = "shape";
+  for (int64_t dim : shape) {
+    name += "_" + std::to_string(dim);
+  }
+  return name;
+}
+
+template <typename Accessor>
+void RegisterAccessor(const char* name,
+                      const std::vector<int64_t>& shape,
+                      Accessor accessor) {
+  RegisterBenchmark(
+      CaseName({name, ShapeName(shape)}),
+      [shape, accessor]() -> BenchBody {
+        at::Tensor tensor = at::ones(shape, at::kFloat);
+        return [tensor, accessor]() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            DoNotOptimize(accessor(tensor));
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+}
+
+// Like RegisterAccessor, for accessors returning an IntArrayRef. Also
+// reports whether two calls return the same buffer (a view of the tensor's
+// own metadata) or a freshly built copy of the shape.
+template <typename Accessor>
+void RegisterShapeAccessor(const char* name,
+                           const std::vector<int64_t>& shape,
+                           Accessor accessor) {
+  RegisterBenchmark(
+      CaseName({name, ShapeName(shape)}),
+      [shape, accessor]() -> BenchBody {
+        at::Tensor tensor = at::ones(shape, at::kFloat);
+        c10::IntArrayRef first = accessor(tensor);
+        c10::IntArrayRef second = accessor(tensor);
+        ReportCounter("stable_buffer", first.data() == second.data() ? 1 : 0);
+        return [tensor, accessor]() {
+          for (int64_t i = 0; i < kCallsPerIter; ++i) {
+            c10::IntArrayRef ref = accessor(tensor);
+            DoNotOptimize(ref.data());
+            DoNotOptimize(ref.size());
+          }
+        };
+      },
+      0,
+      kCallsPerIter);
+}
+
+}  // namespace
+
+// The metadata accessors covered by TensorTest, timed per call on tensors
+// of increasing rank.
+BENCH_SUITE(TensorAccessorBench) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      {24}, {2, 3, 4}, {2, 2, 2, 2, 2, 3}};
+  for (const auto& shape : shapes) {
+    RegisterAccessor(
+        "dim", shape, [](const at::Tensor& t) { return t.dim(); });
+    RegisterAccessor(
+        "numel", shape, [](const at::Tensor& t) { return t.numel(); });
+    RegisterShapeAccessor(
+        "sizes", shape, [](const at::Tensor& t) { return t.sizes(); });
+    RegisterShapeAccessor(
+        "strides", shape, [](const at::Tensor& t) { return t.strides(); });
+    RegisterAccessor(
+        "data_ptr", shape, [](const at::Tensor& t) { return t.data_ptr(); });
+    RegisterAccessor("scalar_type", shape, [](const at::Tensor& t) {
+      return t.scalar_type();
+    });
+    RegisterAccessor(
+        "device", shape, [](const at::Tensor& t) { return t.device(); });
+    RegisterAccessor("is_contiguous", shape, [](const at::Tensor& t) {
+      return t.is_contiguous();
+    });
+    RegisterAccessor(
+        "is_cpu", shape, [](const at::Tensor& t) { return t.is_cpu(); });
+    RegisterAccessor("get_device", shape, [](const at::Tensor& t) {
+      return t.get_device();
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace at
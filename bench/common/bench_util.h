@@ -0,0 +1,113 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace at {
+namespace bench {
+
+// Element counts swept by the op benchmarks, from a single cache line up to
+// a tensor that no longer fits in the last level cache.
+inline const std::vector<int64_t>& SweepSizes() {
+  static const std::vector<int64_t> sizes = {
+      16, 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+  return sizes;
+}
+
+// 1, 2, 4, ... up to and including the number of hardware threads, or of
+// the CPUs the runner is pinned to with --cpus.
+inline std::vector<int> ThreadSweep() {
+  int max_threads =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    max_threads = std::max(1, CPU_COUNT(&allowed));
+  }
+  std::vector<int> threads;
+  for (int n = 1; n < max_threads; n *= 2) {
+    threads.push_back(n);
+  }
+  threads.push_back(max_threads);
+  return threads;
+}
+
+inline const char* DtypeName(at::ScalarType dtype) {
+  switch (dtype) {
+    case at::kBool:
+      return "bool";
+    case at::kByte:
+      return "uint8";
+    case at::kChar:
+      return "int8";
+    case at::kShort:
+      return "int16";
+    case at::kInt:
+      return "int32";
+    case at::kLong:
+      return "int64";
+    case at::kHalf:
+      return "float16";
+    case at::kBFloat16:
+      return "bfloat16";
+    case at::kFloat:
+      return "float32";
+    case at::kDouble:
+      return "float64";
+    default:
+      return "unknown";
+  }
+}
+
+inline int64_t DtypeSize(at::ScalarType dtype) {
+  switch (dtype) {
+    case at::kBool:
+    case at::kByte:
+    case at::kChar:
+      return 1;
+    case at::kShort:
+    case at::kHalf:
+    case at::kBFloat16:
+      return 2;
+    case at::kInt:
+    case at::kFloat:
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+// Joins the parts of a case name with '/', e.g. "abs/float32/1024".
+inline std::string CaseName(const std::vector<std::string>& parts) {
+  std::string name;
+  for (const auto& part : parts) {
+    if (!name.empty()) {
+      name += '/';
+    }
+    name += part;
+  }
+  return name;
+}
+
+// A tensor holding both signs, so that kernels cannot take a shortcut on
+// all-zero or all-positive input.
+inline at::Tensor MakeInput(const std::vector<int64_t>& shape,
+                            at::ScalarType dtype) {
+  int64_t numel = 1;
+  for (int64_t dim : shape) {
+    numel *= dim;
+  }
+  at::Tensor values = at::arange(-(numel / 2),
+                                 numel - numel / 2,
+                                 at::TensorOptions().dtype(at::kLong));
+  return values.reshape(shape).toType(dtype);
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,573 @@
+#include "benchmark.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include "alloc_tracker.h"
+#include "machine_state.h"
+#include "perf_counters.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+struct BenchFlags {
+  std::string filter;
+  std::string json_path;
+  // CPUs to pin the runner to, e.g. "2-5"; empty to leave it unpinned.
+  std::string cpus;
+  // Untimed iterations run before calibration.
+  int64_t warmup = 0;
+  // Minimum duration of one repetition.
+  double min_time_ms = 50.0;
+  // Repetitions always run. With target_ci > 0 more are added, up to
+  // max_repetitions, until the 95% confidence interval of the mean is
+  // within target_ci of the mean. Off by default, so the sample count of a
+  // run stays fixed and comparable with earlier runs.
+  int repetitions = 5;
+  int max_repetitions = 30;
+  double target_ci = 0.0;
+  // Collect hardware counters through perf_event_open when permitted.
+  bool perf_counters = true;
+  bool list_only = false;
+};
+
+std::vector<std::pair<const char*, void (*)()>>& Suites() {
+  static std::vector<std::pair<const char*, void (*)()>> suites;
+  return suites;
+}
+
+std::vector<BenchCase>& Cases() {
+  static std::vector<BenchCase> cases;
+  return cases;
+}
+
+std::vector<BenchSummary>& Summaries() {
+  static std::vector<BenchSummary> summaries;
+  return summaries;
+}
+
+// Counters reported through ReportCounter for the case being run.
+std::map<std::string, double>& PendingCounters() {
+  static std::map<std::string, double> counters;
+  return counters;
+}
+
+bool ParseFlag(const char* arg, const char* name, std::string* value) {
+  size_t len = std::strlen(name);
+  if (std::strncmp(arg, name, len) != 0 || arg[len] != '=') {
+    return false;
+  }
+  *value = arg + len + 1;
+  return true;
+}
+
+bool ParseFlags(int argc, char** argv, BenchFlags* flags) {
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    if (ParseFlag(argv[i], "--filter", &value)) {
+      flags->filter = value;
+    } else if (ParseFlag(argv[i], "--json", &value)) {
+      flags->json_path = value;
+    } else if (ParseFlag(argv[i], "--min_time_ms", &value)) {
+      flags->min_time_ms = std::atof(value.c_str());
+    } else if (ParseFlag(argv[i], "--repetitions", &value)) {
+      flags->repetitions = std::max(1, std::atoi(value.c_str()));
+    } else if (ParseFlag(argv[i], "--max_repetitions", &value)) {
+      flags->max_repetitions = std::max(1, std::atoi(value.c_str()));
+    } else if (ParseFlag(argv[i], "--target_ci", &value)) {
+      flags->target_ci = std::max(0.0, std::atof(value.c_str()));
+    } else if (ParseFlag(argv[i], "--warmup", &value)) {
+      flags->warmup = std::max<int64_t>(0, std::atoll(value.c_str()));
+    } else if (ParseFlag(argv[i], "--cpus", &value)) {
+      flags->cpus = value;
+    } else if (ParseFlag(argv[i], "--perf_counters", &value)) {
+      flags->perf_counters = std::atoi(value.c_str()) != 0;
+    } else if (std::strcmp(argv[i], "--list") == 0) {
+      flags->list_only = true;
+    } else {
+      std::cerr << "Unknown flag: " << argv[i] << "\n"
+                << "Usage: " << argv[0]
+                << " [--filter=<substring>] [--json=<path>]"
+                   " [--min_time_ms=<ms>] [--repetitions=<n>]"
+                   " [--max_repetitions=<n>] [--target_ci=<fraction>]"
+                   " [--warmup=<iterations>] [--cpus=<list>]"
+                   " [--perf_counters=0|1] [--list]\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+double TimeIterations(const BenchBody& body, int64_t iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    body();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Grows the iteration count until one repetition lasts at least
+// min_time_ms. The first call also serves as warmup when --warmup is 0.
+int64_t CalibrateIterations(const BenchBody& body, double min_time_ms) {
+  const double target_ns = min_time_ms * 1e6;
+  int64_t iterations = 1;
+  while (true) {
+    double elapsed_ns = TimeIterations(body, iterations);
+    if (elapsed_ns >= target_ns || iterations >= (int64_t{1} << 30)) {
+      return iterations;
+    }
+    double scale = elapsed_ns > 0 ? target_ns / elapsed_ns * 1.2 : 10.0;
+    int64_t next = static_cast<int64_t>(iterations * std::min(scale, 10.0));
+    iterations = std::max(iterations + 1, next);
+  }
+}
+
+// Two-sided 95% quantile of Student's t distribution.
+double StudentT95(size_t degrees_of_freedom) {
+  static const double kTable[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447,
+                                  2.365,  2.306, 2.262, 2.228, 2.201, 2.179,
+                                  2.160,  2.145, 2.131, 2.120, 2.110, 2.101,
+                                  2.093,  2.086, 2.080, 2.074, 2.069, 2.064,
+                                  2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+  const size_t table_size = sizeof(kTable) / sizeof(kTable[0]);
+  if (degrees_of_freedom == 0) {
+    return 0.0;
+  }
+  return degrees_of_freedom <= table_size ? kTable[degrees_of_freedom - 1]
+                                          : 1.96;
+}
+
+// Involuntary context switches of the calling thread so far: how often the
+// scheduler took the CPU away from the timed loop.
+int64_t InvoluntaryContextSwitches() {
+  rusage usage;
+  return getrusage(RUSAGE_THREAD, &usage) == 0 ? usage.ru_nivcsw : 0;
+}
+
+void ComputeStats(BenchResult* result) {
+  std::vector<double> sorted = result->samples_ns;
+  std::sort(sorted.begin(), sorted.end());
+  size_t n = sorted.size();
+  result->median_ns = n % 2 ? sorted[n / 2]
+                            : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+  result->min_ns = sorted.front();
+  double sum = 0.0;
+  for (double sample : sorted) {
+    sum += sample;
+  }
+  result->mean_ns = sum / n;
+  double sq = 0.0;
+  for (double sample : sorted) {
+    sq += (sample - result->mean_ns) * (sample - result->mean_ns);
+  }
+  result->stddev_ns = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+  result->ci95_ns = StudentT95(n - 1) * result->stddev_ns / std::sqrt(n);
+}
+
+bool Converged(const BenchResult& result, double target_ci) {
+  return target_ci <= 0 || result.ci95_ns <= target_ci * result.mean_ns;
+}
+
+// Time a case may spend in repetitions added to reach --target_ci, so one
+// noisy multi-second case cannot hold up the whole run.
+constexpr double kMaxAdaptiveNs = 10e9;
+
+BenchResult RunCase(const BenchCase& bench_case,
+                    const BenchFlags& flags,
+                    PerfCounters* perf) {
+  BenchResult result;
+  result.name = bench_case.name;
+  result.bytes_per_iter = bench_case.bytes_per_iter;
+  result.items_per_iter = std::max<int64_t>(1, bench_case.items_per_iter);
+
+  PendingCounters().clear();
+  BenchBody body = bench_case.setup();
+  TimeIterations(body, flags.warmup);
+  result.iterations = CalibrateIterations(body, flags.min_time_ms);
+  int64_t switches = InvoluntaryContextSwitches();
+  double adaptive_ns = 0.0;
+  while (true) {
+    double elapsed_ns = TimeIterations(body, result.iterations);
+    result.samples_ns.push_back(elapsed_ns / result.iterations);
+    int samples = static_cast<int>(result.samples_ns.size());
+    if (samples < flags.repetitions) {
+      continue;
+    }
+    if (samples > flags.repetitions) {
+      adaptive_ns += elapsed_ns;
+    }
+    ComputeStats(&result);
+    if (Converged(result, flags.target_ci) ||
+        samples >= std::max(flags.repetitions, flags.max_repetitions) ||
+        adaptive_ns >= kMaxAdaptiveNs) {
+      break;
+    }
+  }
+  result.counters["ctx_switches_per_rep"] =
+      static_cast<double>(InvoluntaryContextSwitches() - switches) /
+      result.samples_ns.size();
+  if (!Converged(result, flags.target_ci)) {
+    result.counters["ci_not_converged"] = 1;
+  }
+
+  if (test::AllocTrackingAvailable()) {
+    // Counted in a separate pass so the timed loops stay untouched.
+    int64_t iterations = std::min<int64_t>(result.iterations, 100);
+    test::AllocScope scope;
+    TimeIterations(body, iterations);
+    test::AllocStats stats = scope.Stats();
+    result.counters["allocs_per_iter"] =
+        static_cast<double>(stats.allocs) / iterations;
+    result.counters["alloc_bytes_per_iter"] =
+        static_cast<double>(stats.bytes) / iterations;
+    if (result.items_per_iter > 1) {
+      result.counters["allocs_per_item"] =
+          static_cast<double>(stats.allocs) / iterations /
+          result.items_per_iter;
+    }
+  }
+  if (perf != nullptr) {
+    // Counted in its own pass as well, one repetition long.
+    perf->Start();
+    TimeIterations(body, result.iterations);
+    std::map<std::string, double> values = perf->Stop();
+    for (const auto& value : values) {
+      result.counters[value.first + "_per_iter"] =
+          value.second / result.iterations;
+    }
+    if (values.count("cycles") && values.count("instructions") &&
+        values["cycles"] > 0) {
+      result.counters["ipc"] = values["instructions"] / values["cycles"];
+    }
+  }
+  if (result.items_per_iter > 1) {
+    result.counters["ns_per_item"] = result.median_ns / result.items_per_iter;
+  }
+  for (const auto& counter : PendingCounters()) {
+    result.counters[counter.first] = counter.second;
+  }
+  return result;
+}
+
+void PrintResult(const BenchResult& result) {
+  char line[512];
+  std::snprintf(line,
+                sizeof(line),
+                "%-56s %12lld %14.1f %12.1f %8.2f %10.2f",
+                result.name.c_str(),
+                static_cast<long long>(result.iterations),  // NOLINT
+                result.median_ns,
+                result.stddev_ns,
+                result.mean_ns > 0 ? 100 * result.ci95_ns / result.mean_ns
+                                   : 0.0,
+                GigabytesPerSecond(result));
+  std::cout << line;
+  for (const auto& counter : result.counters) {
+    std::cout << "  " << counter.first << "=" << counter.second;
+  }
+  std::cout << std::endl;
+}
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        out += c;
+    }
+  }
+  return out;
+}
+
+std::string JsonNumber(double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::ostringstream os;
+  os.precision(10);
+  os << value;
+  return os.str();
+}
+
+void WriteMachineJson(std::ostream& out, const MachineState& machine) {
+  out << "  \"machine\": {\"online_cpus\": " << machine.online_cpus
+      << ", \"affinity\": \"" << JsonEscape(machine.affinity)
+      << "\", \"governor\": \"" << JsonEscape(machine.governor)
+      << "\", \"smt\": \"" << JsonEscape(machine.smt)
+      << "\", \"turbo\": " << machine.turbo << ", \"loadavg\": ["
+      << JsonNumber(machine.loadavg[0]) << ", "
+      << JsonNumber(machine.loadavg[1]) << ", "
+      << JsonNumber(machine.loadavg[2]) << "], \"warnings\": [";
+  std::vector<std::string> warnings = NoiseWarnings(machine);
+  for (size_t i = 0; i < warnings.size(); ++i) {
+    out << (i ? ", " : "") << "\"" << JsonEscape(warnings[i]) << "\"";
+  }
+  out << "]},\n";
+}
+
+bool WriteJson(const std::string& path,
+               const char* binary,
+               const BenchFlags& flags,
+               const MachineState& machine,
+               const std::string& perf_status,
+               const std::vector<BenchResult>& results) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Cannot open " << path << " for writing\n";
+    return false;
+  }
+  out << "{\n  \"backend\": \"" << kBackendName << "\",\n"
+      << "  \"binary\": \"" << JsonEscape(binary) << "\",\n"
+      << "  \"perf_counters\": \"" << JsonEscape(perf_status) << "\",\n"
+      << "  \"settings\": {\"warmup\": " << flags.warmup
+      << ", \"min_time_ms\": " << JsonNumber(flags.min_time_ms)
+      << ", \"repetitions\": " << flags.repetitions
+      << ", \"max_repetitions\": " << flags.max_repetitions
+      << ", \"target_ci\": " << JsonNumber(flags.target_ci) << "},\n";
+  WriteMachineJson(out, machine);
+  out << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult& r = results[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << JsonEscape(r.name)
+        << "\", \"iterations\": " << r.iterations
+        << ", \"median_ns\": " << JsonNumber(r.median_ns)
+        << ", \"mean_ns\": " << JsonNumber(r.mean_ns)
+        << ", \"stddev_ns\": " << JsonNumber(r.stddev_ns)
+        << ", \"ci95_ns\": " << JsonNumber(r.ci95_ns)
+        << ", \"min_ns\": " << JsonNumber(r.min_ns)
+        << ", \"bytes_per_iter\": " << r.bytes_per_iter
+        << ", \"items_per_iter\": " << r.items_per_iter
+        << ", \"gb_per_s\": " << JsonNumber(GigabytesPerSecond(r))
+        << ", \"samples_ns\": [";
+    for (size_t j = 0; j < r.samples_ns.size(); ++j) {
+      out << (j ? ", " : "") << JsonNumber(r.samples_ns[j]);
+    }
+    out << "], \"counters\": {";
+    bool first = true;
+    for (const auto& counter : r.counters) {
+      out << (first ? "" : ", ") << "\"" << JsonEscape(counter.first)
+          << "\": " << JsonNumber(counter.second);
+      first = false;
+    }
+    out << "}}";
+  }
+  out << "\n  ]\n}\n";
+  return static_cast<bool>(out);
+}
+
+}  // namespace
+
+double GigabytesPerSecond(const BenchResult& result) {
+  if (result.bytes_per_iter <= 0 || result.median_ns <= 0) {
+    return 0.0;
+  }
+  return result.bytes_per_iter / result.median_ns;
+}
+
+void RegisterBenchmark(const std::string& name,
+                       BenchSetup setup,
+                       int64_t bytes_per_iter,
+                       int64_t items_per_iter) {
+  Cases().push_back(
+      BenchCase{name, std::move(setup), bytes_per_iter, items_per_iter});
+}
+
+void ReportCounter(const std::string& name, double value) {
+  PendingCounters()[name] = value;
+}
+
+void RegisterSummary(BenchSummary summary) {
+  Summaries().push_back(std::move(summary));
+}
+
+void RegisterThreadScalingSummary() {
+  RegisterSummary([](std::vector<BenchResult>* results) {
+    const std::string kThreadsTag = "/threads";
+    std::vector<std::string> order;
+    std::map<std::string, std::map<int, BenchResult*>> groups;
+    for (BenchResult& result : *results) {
+      size_t pos = result.name.rfind(kThreadsTag);
+      if (pos == std::string::npos) {
+        continue;
+      }
+      int threads = std::atoi(result.name.c_str() + pos + kThreadsTag.size());
+      std::string group = result.name.substr(0, pos);
+      if (threads <= 0) {
+        continue;
+      }
+      if (groups.find(group) == groups.end()) {
+        order.push_back(group);
+      }
+      groups[group][threads] = &result;
+    }
+    if (order.empty()) {
+      return;
+    }
+
+    char line[256];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-48s %8s %10s %10s %11s",
+                  "scaling group",
+                  "threads",
+                  "GB/s",
+                  "speedup",
+                  "efficiency");
+    std::cout << "\n" << line << std::endl;
+    for (const std::string& group : order) {
+      const auto& by_threads = groups[group];
+      auto base = by_threads.find(1);
+      if (base == by_threads.end() || base->second->median_ns <= 0) {
+        continue;
+      }
+      // Per item, so cases that split a fixed amount of work unevenly over
+      // the threads still compare like for like.
+      double base_ns_per_item =
+          base->second->median_ns / base->second->items_per_iter;
+      for (const auto& entry : by_threads) {
+        BenchResult* result = entry.second;
+        double ns_per_item = result->median_ns / result->items_per_iter;
+        double speedup = base_ns_per_item / ns_per_item;
+        double efficiency = speedup / entry.first;
+        result->counters["speedup"] = speedup;
+        result->counters["parallel_efficiency"] = efficiency;
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-48s %8d %10.2f %10.2f %10.1f%%",
+                      group.c_str(),
+                      entry.first,
+                      GigabytesPerSecond(*result),
+                      speedup,
+                      efficiency * 100);
+        std::cout << line << std::endl;
+      }
+    }
+  });
+}
+
+bool RegisterSuite(const char* name, void (*register_fn)()) {
+  Suites().emplace_back(name, register_fn);
+  return true;
+}
+
+int RunBenchmarks(int argc, char** argv) {
+  BenchFlags flags;
+  if (!ParseFlags(argc, argv, &flags)) {
+    return 1;
+  }
+  // Before the suites register, since some size their thread sweep by the
+  // allowed CPUs, and before any backend thread pool exists.
+  if (!flags.cpus.empty()) {
+    std::vector<int> cpus;
+    std::string error;
+    if (!ParseCpuList(flags.cpus, &cpus)) {
+      std::cerr << "Invalid --cpus list: " << flags.cpus << "\n";
+      return 1;
+    }
+    if (!PinToCpus(cpus, &error)) {
+      std::cerr << "Cannot pin to CPUs " << flags.cpus << ": " << error
+                << "\n";
+      return 1;
+    }
+  }
+  for (const auto& suite : Suites()) {
+    suite.second();
+  }
+
+  std::vector<const BenchCase*> selected;
+  for (const BenchCase& bench_case : Cases()) {
+    if (flags.filter.empty() ||
+        bench_case.name.find(flags.filter) != std::string::npos) {
+      selected.push_back(&bench_case);
+    }
+  }
+  if (flags.list_only) {
+    for (const BenchCase* bench_case : selected) {
+      std::cout << bench_case->name << "\n";
+    }
+    return 0;
+  }
+
+  // Opened once before the first case; see PerfCounters for which threads
+  // are counted.
+  std::unique_ptr<PerfCounters> perf;
+  std::string perf_status = "disabled";
+  if (flags.perf_counters) {
+    perf.reset(new PerfCounters());
+    if (perf->Available() && !perf->Missing().empty()) {
+      perf_status = "partial, missing " + perf->Missing();
+      std::cerr << "perf counters " << perf_status << "\n";
+    } else if (perf->Available()) {
+      perf_status = "available";
+    } else {
+      perf_status = "unavailable: " + perf->Error();
+      std::cerr << "perf counters " << perf_status << "\n";
+      perf.reset();
+    }
+  }
+
+  MachineState machine = ReadMachineState();
+  for (const std::string& warning : NoiseWarnings(machine)) {
+    std::cerr << "warning: " << warning << "\n";
+  }
+
+  char header[256];
+  std::snprintf(header,
+                sizeof(header),
+                "%-56s %12s %14s %12s %8s %10s",
+                "case",
+                "iterations",
+                "median(ns)",
+                "stddev(ns)",
+                "ci95(%)",
+                "GB/s");
+  std::cout << "backend: " << kBackendName << "\n"
+            << "machine: cpus=" << machine.affinity << " of "
+            << machine.online_cpus << " governor="
+            << (machine.governor.empty() ? "unknown" : machine.governor)
+            << " smt=" << (machine.smt.empty() ? "unknown" : machine.smt)
+            << " load=" << machine.loadavg[0] << "\n"
+            << header << std::endl;
+
+  std::vector<BenchResult> results;
+  for (const BenchCase* bench_case : selected) {
+    results.push_back(RunCase(*bench_case, flags, perf.get()));
+    PrintResult(results.back());
+  }
+
+  for (const BenchSummary& summary : Summaries()) {
+    summary(&results);
+  }
+
+  if (!flags.json_path.empty() &&
+      !WriteJson(
+          flags.json_path, argv[0], flags, machine, perf_status, results)) {
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace at {
+namespace bench {
+
+// Backend the binary was built against. Written into every result so the
+// output of paddle_bench_* and torch_bench_* can be merged side by side.
+#if USE_PADDLE_API
+constexpr const char* kBackendName = "paddle";
+#else
+constexpr const char* kBackendName = "torch";
+#endif
+
+// One timed iteration of a benchmark case.
+using BenchBody = std::function<void()>;
+
+// Creates the inputs of a case and returns the body that uses them. It is
+// called right before the case is timed and the body is destroyed right
+// after, so the large inputs of different cases are never alive together.
+using BenchSetup = std::function<BenchBody()>;
+
+struct BenchCase {
+  std::string name;
+  BenchSetup setup;
+  // Bytes read plus bytes written by one iteration, 0 when not meaningful.
+  int64_t bytes_per_iter = 0;
+  // Calls made by one iteration. Bodies of very cheap calls repeat them to
+  // amortize the timing overhead; results are then also reported per call.
+  int64_t items_per_iter = 1;
+};
+
+struct BenchResult {
+  std::string name;
+  // Iterations timed per repetition.
+  int64_t iterations = 0;
+  // Average time of one iteration, one entry per repetition.
+  std::vector<double> samples_ns;
+  double median_ns = 0;
+  double mean_ns = 0;
+  double stddev_ns = 0;
+  // Half-width of the 95% confidence interval of the mean.
+  double ci95_ns = 0;
+  double min_ns = 0;
+  int64_t bytes_per_iter = 0;
+  int64_t items_per_iter = 1;
+  std::map<std::string, double> counters;
+};
+
+// bytes_per_iter over the median time, 0 when either is not positive.
+double GigabytesPerSecond(const BenchResult& result);
+
+void RegisterBenchmark(const std::string& name,
+                       BenchSetup setup,
+                       int64_t bytes_per_iter = 0,
+                       int64_t items_per_iter = 1);
+
+// Attaches an extra value to the result of the case being run. May be
+// called from a setup function or a body.
+void ReportCounter(const std::string& name, double value);
+
+// Runs after every selected case has finished, before the results are
+// written, e.g. to derive speedups from a group of cases. It may add
+// counters to the results and print its own report.
+using BenchSummary = std::function<void(std::vector<BenchResult>* results)>;
+void RegisterSummary(BenchSummary summary);
+
+// Summary for cases whose name ends in "/threads<N>": adds "speedup" and
+// "parallel_efficiency" counters relative to the "/threads1" case of the
+// same prefix and prints a scaling table. Speedup compares the time per
+// item, so the cases of a group may differ in items_per_iter.
+void RegisterThreadScalingSummary();
+
+// Suites register their cases from main() instead of from static
+// initializers, so no tensor is created before the backend is initialized.
+bool RegisterSuite(const char* name, void (*register_fn)());
+
+// Parses the benchmark flags, runs every registered case that matches
+// --filter and prints the results. Returns the process exit code.
+int RunBenchmarks(int argc, char** argv);
+
+// Keeps the compiler from eliding a result that is otherwise unused.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+
+}  // namespace bench
+}  // namespace at
+
+#define BENCH_SUITE(suite_name)                                       \
+  static void suite_name##Register();                                 \
+  [[maybe_unused]] static const bool suite_name##_registered =        \
+      ::at::bench::RegisterSuite(#suite_name, &suite_name##Register); \
+  static void suite_name##Register()
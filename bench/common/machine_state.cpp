@@ -0,0 +1,184 @@
+#include "machine_state.h"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace at {
+namespace bench {
+namespace {
+
+// First line of a sysfs or procfs file, "" when it cannot be read.
+std::string ReadLine(const std::string& path) {
+  std::ifstream in(path);
+  std::string line;
+  std::getline(in, line);
+  return line;
+}
+
+int ReadTurbo() {
+  // intel_pstate reports the inverse setting.
+  std::string no_turbo =
+      ReadLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+  if (!no_turbo.empty()) {
+    return no_turbo == "0" ? 1 : 0;
+  }
+  std::string boost = ReadLine("/sys/devices/system/cpu/cpufreq/boost");
+  if (!boost.empty()) {
+    return boost == "1" ? 1 : 0;
+  }
+  return -1;
+}
+
+std::string ReadGovernor(const std::vector<int>& cpus) {
+  std::string governor;
+  for (int cpu : cpus) {
+    std::string value =
+        ReadLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                 "/cpufreq/scaling_governor");
+    if (value.empty()) {
+      continue;
+    }
+    if (governor.empty()) {
+      governor = value;
+    } else if (governor != value) {
+      return "mixed";
+    }
+  }
+  return governor;
+}
+
+}  // namespace
+
+MachineState ReadMachineState() {
+  MachineState state;
+  state.online_cpus = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+  std::vector<int> cpus = AllowedCpus();
+  state.affinity = FormatCpuList(cpus);
+  state.governor = ReadGovernor(cpus);
+  state.smt = ReadLine("/sys/devices/system/cpu/smt/control");
+  state.turbo = ReadTurbo();
+  std::istringstream loadavg(ReadLine("/proc/loadavg"));
+  for (double& load : state.loadavg) {
+    if (!(loadavg >> load)) {
+      load = -1;
+    }
+  }
+  return state;
+}
+
+std::vector<std::string> NoiseWarnings(const MachineState& state) {
+  std::vector<std::string> warnings;
+  if (!state.governor.empty() && state.governor != "performance") {
+    warnings.push_back("cpufreq governor is " + state.governor +
+                       ", clocks change with load");
+  }
+  if (state.turbo == 1) {
+    warnings.push_back("turbo boost is enabled, clocks depend on temperature");
+  }
+  if (state.smt == "on" || state.smt == "forceon") {
+    warnings.push_back(
+        "SMT is on, a sibling hyperthread can share the core of a pinned "
+        "CPU");
+  }
+  // More runnable tasks than allowed CPUs means the cases share them.
+  int allowed = 0;
+  std::vector<int> cpus;
+  if (ParseCpuList(state.affinity, &cpus)) {
+    allowed = static_cast<int>(cpus.size());
+  }
+  if (state.loadavg[0] >= 0 && allowed > 0 && state.loadavg[0] >= allowed) {
+    char line[128];
+    std::snprintf(line,
+                  sizeof(line),
+                  "1 minute load average %.2f on %d usable CPUs",
+                  state.loadavg[0],
+                  allowed);
+    warnings.push_back(line);
+  }
+  if (allowed > 0 && allowed == state.online_cpus && state.online_cpus > 1) {
+    warnings.push_back("not pinned, pass --cpus=<list> to isolate the run");
+  }
+  return warnings;
+}
+
+bool ParseCpuList(const std::string& text, std::vector<int>* cpus) {
+  cpus->clear();
+  std::istringstream in(text);
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    char* end = nullptr;
+    long first = std::strtol(range.c_str(), &end, 10);
+    long last = first;
+    if (end == range.c_str()) {
+      return false;
+    }
+    if (*end == '-') {
+      const char* start = end + 1;
+      last = std::strtol(start, &end, 10);
+      if (end == start) {
+        return false;
+      }
+    }
+    if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+      return false;
+    }
+    for (long cpu = first; cpu <= last; ++cpu) {
+      cpus->push_back(static_cast<int>(cpu));
+    }
+  }
+  return !cpus->empty();
+}
+
+std::string FormatCpuList(const std::vector<int>& cpus) {
+  std::string text;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    text += (text.empty() ? "" : ",") + std::to_string(cpus[i]);
+    if (j > i) {
+      text += "-" + std::to_string(cpus[j]);
+    }
+    i = j + 1;
+  }
+  return text;
+}
+
+std::vector<int> AllowedCpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+bool PinToCpus(const std::vector<int>& cpus, std::string* error) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    *error = std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace at {
+namespace bench {
+
+// Machine settings that change timings, recorded with every run so two
+// result files can be checked for comparability. Fields that cannot be
+// read (no cpufreq in a VM, no /sys in a container) are left empty or -1.
+struct MachineState {
+  int online_cpus = 0;
+  // CPUs the runner may use after pinning, e.g. "0-3,8".
+  std::string affinity;
+  // scaling_governor of the allowed CPUs, "mixed" when they differ.
+  std::string governor;
+  // /sys/devices/system/cpu/smt/control: "on", "off", "notsupported", ...
+  std::string smt;
+  // 1 when turbo/boost is enabled, 0 when disabled, -1 when unknown.
+  int turbo = -1;
+  // 1, 5 and 15 minute load averages.
+  double loadavg[3] = {-1, -1, -1};
+};
+
+MachineState ReadMachineState();
+
+// Settings of state that make timings noisy, one line each.
+std::vector<std::string> NoiseWarnings(const MachineState& state);
+
+// Parses a CPU list such as "2,4-7". Returns false when it is malformed.
+bool ParseCpuList(const std::string& text, std::vector<int>* cpus);
+
+std::string FormatCpuList(const std::vector<int>& cpus);
+
+// CPUs in the affinity mask of the calling thread.
+std::vector<int> AllowedCpus();
+
+// Restricts the calling thread to cpus with sched_setaffinity. Threads it
+// creates afterwards inherit the mask, so this must run before the
+// backend starts its thread pools.
+bool PinToCpus(const std::vector<int>& cpus, std::string* error);
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,8 @@
+#include "benchmark.h"
+#if USE_PADDLE_API
+#include "paddle/extension.h"
+#endif
+
+int main(int argc, char** argv) {  // NOLINT
+  return at::bench::RunBenchmarks(argc, argv);
+}
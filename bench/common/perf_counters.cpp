@@ -0,0 +1,109 @@
+#include "perf_counters.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace at {
+namespace bench {
+namespace {
+
+struct CounterSpec {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+const CounterSpec kCounterSpecs[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+// Opens spec as the leader of a new group when group_fd is -1, otherwise
+// as a member of the group of group_fd.
+int OpenCounter(const CounterSpec& spec, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  // Members follow the leader, which is enabled and disabled for the group.
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // pid 0, any CPU: this thread and the threads it creates from now on.
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  for (const CounterSpec& spec : kCounterSpecs) {
+    int leader = counters_.empty() ? -1 : counters_.front().fd;
+    int fd = OpenCounter(spec, leader);
+    if (fd < 0) {
+      std::string reason = std::string(spec.name) + ": " + std::strerror(errno);
+      missing_ += (missing_.empty() ? "" : ", ") + reason;
+      continue;
+    }
+    counters_.push_back(Counter{spec.name, fd});
+  }
+  if (counters_.empty()) {
+    error_ = missing_;
+    missing_.clear();
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const Counter& counter : counters_) {
+    close(counter.fd);
+  }
+}
+
+void PerfCounters::Start() {
+  if (counters_.empty()) {
+    return;
+  }
+  int leader = counters_.front().fd;
+  ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+std::map<std::string, double> PerfCounters::Stop() {
+  std::map<std::string, double> values;
+  if (counters_.empty()) {
+    return values;
+  }
+  ioctl(counters_.front().fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  // value, time_enabled, time_running
+  uint64_t leader[3] = {0, 0, 0};
+  if (read(counters_.front().fd, leader, sizeof(leader)) != sizeof(leader) ||
+      leader[2] == 0) {
+    return values;
+  }
+  // The group is scheduled as a unit, so every member ran over the leader's
+  // window and is scaled by the leader's times. Counts are read per fd
+  // since older kernels refuse PERF_FORMAT_GROUP with inherit.
+  double scale = static_cast<double>(leader[1]) / leader[2];
+  for (const Counter& counter : counters_) {
+    uint64_t data[3] = {0, 0, 0};
+    if (read(counter.fd, data, sizeof(data)) != sizeof(data)) {
+      continue;
+    }
+    values[counter.name] = static_cast<double>(data[0]) * scale;
+  }
+  return values;
+}
+
+}  // namespace bench
+}  // namespace at
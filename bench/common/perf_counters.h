@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace at {
+namespace bench {
+
+// Hardware counters of the calling thread, opened with perf_event_open:
+// cycles, instructions, last level cache misses and branch misses, user
+// space only (so perf_event_paranoid <= 2 suffices). Counts of threads
+// created while the counters are open are added when those threads exit,
+// so threads spawned per call are included but the long-lived workers of
+// an intra-op pool are not; compare counters at one thread.
+//
+// The counters form one group led by cycles, so the kernel schedules them
+// together and ratios such as instructions / cycles cover the same window
+// even when the PMU is multiplexed.
+//
+// Counters the kernel or container refuses (seccomp, paranoid level 3,
+// no PMU in the VM) are left out and listed by Missing(); when none can be
+// opened, Available() returns false and Error() says why.
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool Available() const { return !counters_.empty(); }
+  const std::string& Error() const { return error_; }
+  // "<counter>: <reason>, ..." for counters that could not be opened while
+  // others could, empty otherwise.
+  const std::string& Missing() const { return missing_; }
+
+  // Resets and enables all counters.
+  void Start();
+  // Disables the counters and returns their values since Start(), scaled
+  // up when the kernel multiplexed them. Keyed by "cycles",
+  // "instructions", "llc_misses" and "branch_misses".
+  std::map<std::string, double> Stop();
+
+ private:
+  struct Counter {
+    std::string name;
+    int fd;
+  };
+  std::vector<Counter> counters_;
+  std::string error_;
+  std::string missing_;
+};
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,596 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/sum.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+#if USE_PADDLE_API
+#include "paddle/extension.h"
+#endif
+
+// Differential workload, run through tools/diff_runner.py. Both backends
+// compute the same deterministic workloads. The reference binary
+// (--shm_write) copies every result into its own /dev/shm object; the
+// candidate binary (--shm_compare) maps those objects read-only and diffs
+// its results against them in place, so multi-GB outputs never pass
+// through a file on disk, a pipe or a second copy in the comparing process.
+
+namespace at {
+namespace bench {
+namespace {
+
+constexpr char kMagic[8] = {'P', 'C', 'A', 'T', 'D', 'I', 'F', '1'};
+constexpr int kMaxDims = 8;
+// Results start on their own page, so the mapped data is aligned for
+// every dtype.
+constexpr int64_t kDataOffset = 4096;
+constexpr int64_t kRowLength = 1024;
+
+struct ShmHeader {
+  char magic[8];
+  char dtype[16];
+  int64_t ndim;
+  int64_t sizes[kMaxDims];
+  int64_t nbytes;
+};
+
+struct DiffFlags {
+  std::string write_prefix;
+  std::string compare_prefix;
+  std::string filter;
+  std::string json_path;
+  int64_t numel = int64_t{1} << 24;
+  // Negative: the per-dtype defaults of torch.testing.assert_close.
+  double rtol = -1;
+  double atol = -1;
+  bool list_only = false;
+  bool bytes_needed = false;
+};
+
+struct DiffStats {
+  int64_t numel = 0;
+  // Elements outside atol + rtol * |reference|, NaN mismatches included.
+  int64_t mismatches = 0;
+  int64_t nan_mismatches = 0;
+  double max_abs_err = 0;
+  double max_rel_err = 0;
+  // Largest distance in units in the last place, floating point only.
+  uint64_t max_ulp = 0;
+  int64_t worst_index = -1;
+  bool shape_ok = true;
+};
+
+struct Workload {
+  std::string name;
+  // Size of the result, checked against the real output by --shm_write so
+  // --bytes_needed cannot drift from the workloads.
+  int64_t result_bytes;
+  std::function<at::Tensor()> run;
+};
+
+// Deterministic, backend independent inputs: both binaries fill the same
+// bits from a splitmix64 stream instead of relying on a backend RNG.
+uint64_t SplitMix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Uniform floats in [lo, hi).
+at::Tensor UniformFloat(int64_t rows, uint64_t stream, float lo, float hi) {
+  at::Tensor tensor = at::empty({rows, kRowLength}, at::kFloat);
+  float* data = tensor.data_ptr<float>();
+  for (int64_t i = 0; i < rows * kRowLength; ++i) {
+    uint64_t bits = SplitMix64(stream * 0x100000000ull + i);
+    data[i] = lo + (hi - lo) * static_cast<float>(bits >> 40) / (1 << 24);
+  }
+  return tensor;
+}
+
+// Uniform int64 in [-2^20, 2^20).
+at::Tensor UniformLong(int64_t rows, uint64_t stream) {
+  at::Tensor tensor = at::empty({rows, kRowLength}, at::kLong);
+  int64_t* data = tensor.data_ptr<int64_t>();
+  for (int64_t i = 0; i < rows * kRowLength; ++i) {
+    uint64_t bits = SplitMix64(stream * 0x100000000ull + i);
+    data[i] = static_cast<int64_t>(bits >> 43) - (int64_t{1} << 20);
+  }
+  return tensor;
+}
+
+std::vector<Workload> MakeWorkloads(int64_t numel) {
+  int64_t rows = std::max<int64_t>(1, numel / kRowLength);
+  // Created on first use and shared by the workloads that read them.
+  auto x = std::make_shared<at::Tensor>();
+  auto y = std::make_shared<at::Tensor>();
+  auto xi = std::make_shared<at::Tensor>();
+  auto get_x = [x, rows]() {
+    if (!x->defined()) {
+      *x = UniformFloat(rows, 1, -1.0f, 1.0f);
+    }
+    return *x;
+  };
+  auto get_y = [y, rows]() {
+    if (!y->defined()) {
+      *y = UniformFloat(rows, 2, -1000.0f, 1000.0f);
+    }
+    return *y;
+  };
+  auto get_xi = [xi, rows]() {
+    if (!xi->defined()) {
+      *xi = UniformLong(rows, 3);
+    }
+    return *xi;
+  };
+  int64_t total = rows * kRowLength;
+  return {
+      {"abs.float32", total * 4, [get_x]() { return at::abs(get_x()); }},
+      {"abs.int64", total * 8, [get_xi]() { return at::abs(get_xi()); }},
+      {"sum.float32", 4, [get_x]() { return at::sum(get_x()); }},
+      {"sum_to_float64.float32",
+       8,
+       [get_x]() { return at::sum(get_x(), at::kDouble); }},
+      {"sum_rows.float32",
+       rows * 4,
+       [get_x]() { return at::sum(get_x(), {1}, false); }},
+      {"sum_cols.float32",
+       kRowLength * 4,
+       [get_x]() { return at::sum(get_x(), {0}, false); }},
+      {"cat_column_halves.float32",
+       total * 4,
+       [get_x]() {
+         at::Tensor input = get_x();
+         std::vector<at::Tensor> halves = {
+             input.slice(1, 0, kRowLength / 2),
+             input.slice(1, kRowLength / 2, kRowLength)};
+         return at::cat(halves, 0);
+       }},
+      {"transpose_contiguous.float32",
+       total * 4,
+       [get_x]() { return get_x().t().contiguous(); }},
+      {"permute_reshape.float32",
+       total * 4,
+       [get_x, rows, total]() {
+         return get_x()
+             .reshape({rows, 32, 32})
+             .permute({2, 0, 1})
+             .reshape({total});
+       }},
+      {"toType.float32_to_float64",
+       total * 8,
+       [get_x]() { return get_x().toType(at::kDouble); }},
+      {"toType.float32_to_int32",
+       total * 4,
+       [get_y]() { return get_y().toType(at::kInt); }},
+      {"toType.int64_to_float32",
+       total * 4,
+       [get_xi]() { return get_xi().toType(at::kFloat); }},
+      {"arange.float32",
+       total * 4,
+       [total]() {
+         return at::arange(total, at::TensorOptions().dtype(at::kFloat));
+       }},
+      {"arange.float64",
+       total * 8,
+       [total]() {
+         return at::arange(total, at::TensorOptions().dtype(at::kDouble));
+       }},
+  };
+}
+
+std::string ShmPath(const std::string& prefix, const std::string& name) {
+  return "/dev/shm/" + prefix + "." + name;
+}
+
+// Maps an existing /dev/shm object, or creates one with its full size
+// reserved up front (so a full tmpfs fails here instead of with SIGBUS on
+// the first write). Returns nullptr after printing the error.
+void* MapShm(const std::string& path, int64_t create_bytes, int64_t* size) {
+  bool create = create_bytes >= 0;
+  int fd = create ? open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600)
+                  : open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::perror(path.c_str());
+    return nullptr;
+  }
+  if (create) {
+    int err = posix_fallocate(fd, 0, create_bytes);
+    if (err != 0) {
+      std::cerr << path << ": " << std::strerror(err) << "\n";
+      close(fd);
+      return nullptr;
+    }
+    *size = create_bytes;
+  } else {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      std::perror(path.c_str());
+      close(fd);
+      return nullptr;
+    }
+    *size = st.st_size;
+  }
+  void* addr = mmap(nullptr,
+                    *size,
+                    create ? PROT_READ | PROT_WRITE : PROT_READ,
+                    MAP_SHARED,
+                    fd,
+                    0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    std::perror(path.c_str());
+    return nullptr;
+  }
+  return addr;
+}
+
+bool WriteResult(const std::string& path, const at::Tensor& result) {
+  if (result.dim() > kMaxDims) {
+    std::cerr << path << ": more than " << kMaxDims << " dims\n";
+    return false;
+  }
+  int64_t nbytes = result.numel() * static_cast<int64_t>(result.element_size());
+  int64_t size = 0;
+  void* addr = MapShm(path, kDataOffset + nbytes, &size);
+  if (addr == nullptr) {
+    return false;
+  }
+  ShmHeader* header = static_cast<ShmHeader*>(addr);
+  std::memcpy(header->magic, kMagic, sizeof(kMagic));
+  std::snprintf(header->dtype,
+                sizeof(header->dtype),
+                "%s",
+                DtypeName(result.scalar_type()));
+  header->ndim = result.dim();
+  for (int64_t i = 0; i < result.dim(); ++i) {
+    header->sizes[i] = result.size(i);
+  }
+  header->nbytes = nbytes;
+  if (nbytes > 0) {
+    // One strided copy straight into the shared pages, no contiguous()
+    // temporary.
+    at::Tensor shared =
+        at::from_blob(static_cast<char*>(addr) + kDataOffset,
+                      result.sizes(),
+                      at::TensorOptions().dtype(result.scalar_type()));
+    shared.copy_(result);
+  }
+  munmap(addr, size);
+  return true;
+}
+
+// Orders the bit patterns of floats like their values, so the distance
+// between two patterns is the ULP distance.
+template <typename UInt>
+UInt OrderedBits(UInt bits) {
+  constexpr UInt kSign = UInt{1} << (sizeof(UInt) * 8 - 1);
+  return (bits & kSign) ? ~bits : (bits | kSign);
+}
+
+template <typename T, typename UInt>
+void DiffFloat(const T* actual,
+               const T* expected,
+               double rtol,
+               double atol,
+               DiffStats* stats) {
+  double worst = -1;
+  for (int64_t i = 0; i < stats->numel; ++i) {
+    T a = actual[i];
+    T e = expected[i];
+    if (std::isnan(a) || std::isnan(e)) {
+      if (std::isnan(a) != std::isnan(e)) {
+        ++stats->nan_mismatches;
+        ++stats->mismatches;
+      }
+      continue;
+    }
+    if (a == e) {
+      continue;
+    }
+    double abs_err = std::fabs(static_cast<double>(a) - e);
+    double rel_err = e != 0 ? abs_err / std::fabs(static_cast<double>(e))
+                            : std::numeric_limits<double>::infinity();
+    UInt a_bits;
+    UInt e_bits;
+    std::memcpy(&a_bits, &a, sizeof(T));
+    std::memcpy(&e_bits, &e, sizeof(T));
+    UInt ordered_a = OrderedBits(a_bits);
+    UInt ordered_e = OrderedBits(e_bits);
+    uint64_t ulp = ordered_a > ordered_e ? ordered_a - ordered_e
+                                         : ordered_e - ordered_a;
+    if (abs_err > atol + rtol * std::fabs(static_cast<double>(e))) {
+      ++stats->mismatches;
+    }
+    if (abs_err > worst) {
+      worst = abs_err;
+      stats->worst_index = i;
+    }
+    stats->max_abs_err = std::max(stats->max_abs_err, abs_err);
+    stats->max_rel_err = std::max(stats->max_rel_err, rel_err);
+    stats->max_ulp = std::max(stats->max_ulp, ulp);
+  }
+}
+
+template <typename T>
+void DiffExact(const T* actual, const T* expected, DiffStats* stats) {
+  for (int64_t i = 0; i < stats->numel; ++i) {
+    if (actual[i] == expected[i]) {
+      continue;
+    }
+    double abs_err =
+        std::fabs(static_cast<double>(actual[i]) - expected[i]);
+    if (abs_err > stats->max_abs_err) {
+      stats->max_abs_err = abs_err;
+      stats->worst_index = i;
+    }
+    ++stats->mismatches;
+  }
+}
+
+bool CompareResult(const std::string& path,
+                   const at::Tensor& result,
+                   const DiffFlags& flags,
+                   DiffStats* stats) {
+  int64_t size = 0;
+  void* addr = MapShm(path, -1, &size);
+  if (addr == nullptr) {
+    return false;
+  }
+  const ShmHeader* header = static_cast<const ShmHeader*>(addr);
+  at::Tensor actual = result.contiguous();
+  stats->numel = actual.numel();
+  int64_t nbytes = actual.numel() * static_cast<int64_t>(actual.element_size());
+  // A short or stale object with the same prefix must not be read past its
+  // end, so the header is only trusted once the object is large enough.
+  if (size < kDataOffset ||
+      std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->nbytes != nbytes || size - kDataOffset < header->nbytes ||
+      std::string(header->dtype,
+                  strnlen(header->dtype, sizeof(header->dtype))) !=
+          DtypeName(actual.scalar_type()) ||
+      header->ndim != actual.dim() || header->ndim > kMaxDims) {
+    stats->shape_ok = false;
+  } else {
+    for (int64_t i = 0; i < actual.dim(); ++i) {
+      stats->shape_ok = stats->shape_ok && header->sizes[i] == actual.size(i);
+    }
+  }
+  if (!stats->shape_ok) {
+    std::cerr << path
+              << ": size, dtype or shape differs from the reference\n";
+    munmap(addr, size);
+    return true;
+  }
+  const void* expected = static_cast<const char*>(addr) + kDataOffset;
+  const void* data = actual.data_ptr();
+  switch (actual.scalar_type()) {
+    case at::kFloat:
+      DiffFloat<float, uint32_t>(static_cast<const float*>(data),
+                                 static_cast<const float*>(expected),
+                                 flags.rtol >= 0 ? flags.rtol : 1.3e-6,
+                                 flags.atol >= 0 ? flags.atol : 1e-5,
+                                 stats);
+      break;
+    case at::kDouble:
+      DiffFloat<double, uint64_t>(static_cast<const double*>(data),
+                                  static_cast<const double*>(expected),
+                                  flags.rtol >= 0 ? flags.rtol : 1e-7,
+                                  flags.atol >= 0 ? flags.atol : 1e-7,
+                                  stats);
+      break;
+    case at::kInt:
+      DiffExact(static_cast<const int32_t*>(data),
+                static_cast<const int32_t*>(expected),
+                stats);
+      break;
+    case at::kLong:
+      DiffExact(static_cast<const int64_t*>(data),
+                static_cast<const int64_t*>(expected),
+                stats);
+      break;
+    default:
+      std::cerr << path << ": unsupported dtype "
+                << DtypeName(actual.scalar_type()) << "\n";
+      stats->shape_ok = false;
+  }
+  munmap(addr, size);
+  return true;
+}
+
+bool ParseFlag(const char* arg, const char* name, std::string* value) {
+  size_t len = std::strlen(name);
+  if (std::strncmp(arg, name, len) != 0 || arg[len] != '=') {
+    return false;
+  }
+  *value = arg + len + 1;
+  return true;
+}
+
+bool ParseFlags(int argc, char** argv, DiffFlags* flags) {
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    if (ParseFlag(argv[i], "--shm_write", &value)) {
+      flags->write_prefix = value;
+    } else if (ParseFlag(argv[i], "--shm_compare", &value)) {
+      flags->compare_prefix = value;
+    } else if (ParseFlag(argv[i], "--filter", &value)) {
+      flags->filter = value;
+    } else if (ParseFlag(argv[i], "--json", &value)) {
+      flags->json_path = value;
+    } else if (ParseFlag(argv[i], "--numel", &value)) {
+      flags->numel = std::max<int64_t>(1, std::atoll(value.c_str()));
+    } else if (ParseFlag(argv[i], "--rtol", &value)) {
+      flags->rtol = std::atof(value.c_str());
+    } else if (ParseFlag(argv[i], "--atol", &value)) {
+      flags->atol = std::atof(value.c_str());
+    } else if (std::strcmp(argv[i], "--list") == 0) {
+      flags->list_only = true;
+    } else if (std::strcmp(argv[i], "--bytes_needed") == 0) {
+      flags->bytes_needed = true;
+    } else {
+      std::cerr << "Unknown flag: " << argv[i] << "\n";
+      return false;
+    }
+  }
+  if (!flags->list_only && !flags->bytes_needed &&
+      flags->write_prefix.empty() == flags->compare_prefix.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " (--shm_write=<prefix> | --shm_compare=<prefix>)"
+                 " [--numel=<n>] [--filter=<substring>] [--rtol=<r>]"
+                 " [--atol=<a>] [--json=<path>] [--list]"
+                 " [--bytes_needed]\n";
+    return false;
+  }
+  return true;
+}
+
+bool Passed(const DiffStats& stats) {
+  return stats.shape_ok && stats.mismatches == 0;
+}
+
+bool WriteJson(const std::string& path,
+               const std::vector<std::string>& names,
+               const std::vector<DiffStats>& stats) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Cannot open " << path << " for writing\n";
+    return false;
+  }
+  out << "{\n  \"backend\": \"" << kBackendName << "\",\n  \"results\": [";
+  for (size_t i = 0; i < names.size(); ++i) {
+    const DiffStats& s = stats[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << names[i]
+        << "\", \"numel\": " << s.numel << ", \"shape_ok\": "
+        << (s.shape_ok ? "true" : "false")
+        << ", \"mismatches\": " << s.mismatches
+        << ", \"nan_mismatches\": " << s.nan_mismatches
+        << ", \"max_abs_err\": " << s.max_abs_err
+        << ", \"max_rel_err\": "
+        << (std::isfinite(s.max_rel_err) ? std::to_string(s.max_rel_err)
+                                         : "null")
+        << ", \"max_ulp\": " << s.max_ulp
+        << ", \"worst_index\": " << s.worst_index
+        << ", \"pass\": " << (Passed(s) ? "true" : "false") << "}";
+  }
+  out << "\n  ]\n}\n";
+  return static_cast<bool>(out);
+}
+
+}  // namespace
+}  // namespace bench
+}  // namespace at
+
+int main(int argc, char** argv) {  // NOLINT
+  using namespace at::bench;  // NOLINT
+  DiffFlags flags;
+  if (!ParseFlags(argc, argv, &flags)) {
+    return 1;
+  }
+  std::vector<Workload> workloads;
+  for (Workload& workload : MakeWorkloads(flags.numel)) {
+    if (flags.filter.empty() ||
+        workload.name.find(flags.filter) != std::string::npos) {
+      workloads.push_back(std::move(workload));
+    }
+  }
+  if (flags.list_only) {
+    for (const Workload& workload : workloads) {
+      std::cout << workload.name << "\n";
+    }
+    return 0;
+  }
+  if (flags.bytes_needed) {
+    // /dev/shm space the --shm_write objects of this selection take.
+    int64_t total = 0;
+    for (const Workload& workload : workloads) {
+      total += kDataOffset + workload.result_bytes;
+    }
+    std::cout << total << "\n";
+    return 0;
+  }
+
+  bool writing = !flags.write_prefix.empty();
+  const std::string& prefix =
+      writing ? flags.write_prefix : flags.compare_prefix;
+  std::vector<std::string> names;
+  std::vector<DiffStats> stats;
+  bool ok = true;
+  char line[256];
+  if (!writing) {
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-32s %12s %10s %12s %12s %10s",
+                  "workload",
+                  "numel",
+                  "mismatch",
+                  "max_abs",
+                  "max_rel",
+                  "max_ulp");
+    std::cout << "backend: " << kBackendName << "\n" << line << std::endl;
+  }
+  for (const Workload& workload : workloads) {
+    at::Tensor result = workload.run();
+    std::string path = ShmPath(prefix, workload.name);
+    if (writing) {
+      int64_t nbytes =
+          result.numel() * static_cast<int64_t>(result.element_size());
+      if (nbytes != workload.result_bytes) {
+        std::cerr << workload.name << ": result has " << nbytes
+                  << " bytes, result_bytes says " << workload.result_bytes
+                  << "\n";
+        ok = false;
+        continue;
+      }
+      ok = WriteResult(path, result) && ok;
+      continue;
+    }
+    DiffStats s;
+    if (!CompareResult(path, result, flags, &s)) {
+      ok = false;
+      continue;
+    }
+    names.push_back(workload.name);
+    stats.push_back(s);
+    ok = Passed(s) && ok;
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-32s %12lld %10lld %12.4g %12.4g %10llu %s",
+                  workload.name.c_str(),
+                  static_cast<long long>(s.numel),               // NOLINT
+                  static_cast<long long>(s.mismatches),          // NOLINT
+                  s.max_abs_err,
+                  s.max_rel_err,
+                  static_cast<unsigned long long>(s.max_ulp),  // NOLINT
+                  !s.shape_ok ? "SHAPE" : (Passed(s) ? "ok" : "FAIL"));
+    std::cout << line << std::endl;
+  }
+  if (!flags.json_path.empty() &&
+      !WriteJson(flags.json_path, names, stats)) {
+    return 1;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(AbsBench) {
+  for (at::ScalarType dtype : {at::kFloat, at::kDouble, at::kInt, at::kLong}) {
+    for (int64_t numel : SweepSizes()) {
+      RegisterBenchmark(
+          CaseName({"abs", DtypeName(dtype), std::to_string(numel)}),
+          [dtype, numel]() -> BenchBody {
+            at::Tensor input = MakeInput({numel}, dtype);
+            return [input]() { DoNotOptimize(at::abs(input)); };
+          },
+          2 * numel * DtypeSize(dtype));
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,39 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/arange.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(ArangeBench) {
+  for (at::ScalarType dtype : {at::kLong, at::kInt, at::kFloat, at::kDouble}) {
+    for (int64_t numel : SweepSizes()) {
+      at::TensorOptions options = at::TensorOptions().dtype(dtype);
+      RegisterBenchmark(
+          CaseName({"arange", DtypeName(dtype), std::to_string(numel)}),
+          [numel, options]() -> BenchBody {
+            return [numel, options]() {
+              DoNotOptimize(at::arange(numel, options));
+            };
+          },
+          numel * DtypeSize(dtype));
+      RegisterBenchmark(
+          CaseName({"arange_step", DtypeName(dtype), std::to_string(numel)}),
+          [numel, options]() -> BenchBody {
+            return [numel, options]() {
+              DoNotOptimize(at::arange(-numel, numel, 2, options));
+            };
+          },
+          numel * DtypeSize(dtype));
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,171 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/cat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+struct CatPoint {
+  std::string group;
+  int64_t num_inputs = 0;
+};
+
+// Case name -> fit group and input count, filled at registration.
+std::map<std::string, CatPoint>& CatPoints() {
+  static std::map<std::string, CatPoint> points;
+  return points;
+}
+
+// Solves the 3x3 system a * x = b in place by Gaussian elimination.
+bool Solve3(double a[3][3], double b[3], double x[3]) {
+  // Singularity is judged relative to the entries, which are tiny once the
+  // rows are weighted.
+  double scale = 0.0;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      scale = std::max(scale, std::fabs(a[row][col]));
+    }
+  }
+  for (int col = 0; col < 3; ++col) {
+    int pivot = col;
+    for (int row = col + 1; row < 3; ++row) {
+      if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) {
+        pivot = row;
+      }
+    }
+    if (std::fabs(a[pivot][col]) <= 1e-12 * scale) {
+      return false;
+    }
+    for (int k = 0; k < 3; ++k) {
+      std::swap(a[col][k], a[pivot][k]);
+    }
+    std::swap(b[col], b[pivot]);
+    for (int row = col + 1; row < 3; ++row) {
+      double factor = a[row][col] / a[col][col];
+      for (int k = col; k < 3; ++k) {
+        a[row][k] -= factor * a[col][k];
+      }
+      b[row] -= factor * b[col];
+    }
+  }
+  for (int row = 2; row >= 0; --row) {
+    double sum = b[row];
+    for (int k = row + 1; k < 3; ++k) {
+      sum -= a[row][k] * x[k];
+    }
+    x[row] = sum / a[row][row];
+  }
+  return true;
+}
+
+// Fits time = fixed + per_input * inputs + bytes / bandwidth over every case
+// of a group with least squares, which separates per-tensor bookkeeping
+// from copy bandwidth. The times span several orders of magnitude, so each
+// case is weighted by 1 / median^2, i.e. the fit minimizes relative error
+// and the small cases still determine the fixed and per-input terms.
+void FitCatCost(std::vector<BenchResult>* results) {
+  std::map<std::string, std::vector<const BenchResult*>> groups;
+  for (BenchResult& result : *results) {
+    auto it = CatPoints().find(result.name);
+    if (it == CatPoints().end()) {
+      continue;
+    }
+    groups[it->second.group].push_back(&result);
+    result.counters["ns_per_input"] =
+        result.median_ns / it->second.num_inputs;
+  }
+
+  char line[256];
+  std::snprintf(line,
+                sizeof(line),
+                "%-36s %12s %16s %12s",
+                "cat fit group",
+                "fixed(ns)",
+                "per input(ns)",
+                "GB/s");
+  std::cout << "\n" << line << std::endl;
+  for (const auto& group : groups) {
+    double ata[3][3] = {};
+    double atb[3] = {};
+    for (const BenchResult* result : group.second) {
+      if (result->median_ns <= 0) {
+        continue;
+      }
+      double weight = 1.0 / (result->median_ns * result->median_ns);
+      double row[3] = {1.0,
+                       static_cast<double>(
+                           CatPoints()[result->name].num_inputs),
+                       static_cast<double>(result->bytes_per_iter)};
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          ata[i][j] += weight * row[i] * row[j];
+        }
+        atb[i] += weight * row[i] * result->median_ns;
+      }
+    }
+    double coef[3] = {};
+    if (group.second.size() < 3 || !Solve3(ata, atb, coef)) {
+      continue;
+    }
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-36s %12.1f %16.2f %12.2f",
+                  group.first.c_str(),
+                  coef[0],
+                  coef[1],
+                  coef[2] > 0 ? 1.0 / coef[2] : 0.0);
+    std::cout << line << std::endl;
+  }
+}
+
+}  // namespace
+
+// at::cat over many small inputs, as done when batching per-request
+// tensors. Sweeps the number of inputs, the size of each input, the concat
+// dim and whether the inputs are contiguous.
+BENCH_SUITE(CatThroughputBench) {
+  for (bool contiguous : {true, false}) {
+    for (int64_t dim : {0, 1}) {
+      std::string group = CaseName({"cat_many",
+                                    contiguous ? "contiguous" : "transposed",
+                                    "dim" + std::to_string(dim)});
+      for (int64_t side : {1, 8, 64}) {
+        for (int64_t num_inputs : {1, 16, 128, 1024, 4096}) {
+          std::string name = CaseName({group,
+                                       "elems" + std::to_string(side * side),
+                                       "inputs" + std::to_string(num_inputs)});
+          CatPoints()[name] = CatPoint{group, num_inputs};
+          RegisterBenchmark(
+              name,
+              [contiguous, dim, side, num_inputs]() -> BenchBody {
+                std::vector<at::Tensor> inputs;
+                inputs.reserve(num_inputs);
+                for (int64_t i = 0; i < num_inputs; ++i) {
+                  at::Tensor input = MakeInput({side, side}, at::kFloat);
+                  inputs.push_back(contiguous ? input : input.transpose(0, 1));
+                }
+                return [inputs, dim]() { DoNotOptimize(at::cat(inputs, dim)); };
+              },
+              2 * num_inputs * side * side * DtypeSize(at::kFloat));
+        }
+      }
+    }
+  }
+  RegisterSummary(FitCatCost);
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,45 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/cat.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(ConnectionOpsBench) {
+  constexpr int64_t kCols = 16;
+  for (at::ScalarType dtype : {at::kFloat, at::kLong}) {
+    for (int64_t num_inputs : {2, 8}) {
+      for (int64_t dim : {0, 1}) {
+        for (int64_t numel : SweepSizes()) {
+          // Each input is a {rows, 16} slab; all inputs add up to numel.
+          int64_t rows = std::max<int64_t>(1, numel / (num_inputs * kCols));
+          int64_t total = rows * kCols * num_inputs;
+          RegisterBenchmark(
+              CaseName({"cat",
+                        DtypeName(dtype),
+                        "inputs" + std::to_string(num_inputs),
+                        "dim" + std::to_string(dim),
+                        std::to_string(total)}),
+              [dtype, num_inputs, dim, rows]() -> BenchBody {
+                std::vector<at::Tensor> inputs;
+                for (int64_t i = 0; i < num_inputs; ++i) {
+                  inputs.push_back(MakeInput({rows, kCols}, dtype));
+                }
+                return [inputs, dim]() { DoNotOptimize(at::cat(inputs, dim)); };
+              },
+              2 * total * DtypeSize(dtype));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
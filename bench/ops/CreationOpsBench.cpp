@@ -0,0 +1,59 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/zeros.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(CreationOpsBench) {
+  for (at::ScalarType dtype : {at::kFloat, at::kDouble, at::kInt, at::kLong}) {
+    at::TensorOptions options = at::TensorOptions().dtype(dtype);
+    for (int64_t numel : SweepSizes()) {
+      std::string size = std::to_string(numel);
+      int64_t bytes = numel * DtypeSize(dtype);
+      RegisterBenchmark(
+          CaseName({"zeros", DtypeName(dtype), size}),
+          [numel, options]() -> BenchBody {
+            return [numel, options]() {
+              DoNotOptimize(at::zeros({numel}, options));
+            };
+          },
+          bytes);
+      RegisterBenchmark(
+          CaseName({"ones", DtypeName(dtype), size}),
+          [numel, options]() -> BenchBody {
+            return [numel, options]() {
+              DoNotOptimize(at::ones({numel}, options));
+            };
+          },
+          bytes);
+      RegisterBenchmark(
+          CaseName({"full", DtypeName(dtype), size}),
+          [numel, options]() -> BenchBody {
+            return [numel, options]() {
+              DoNotOptimize(at::full({numel}, 5, options));
+            };
+          },
+          bytes);
+      // empty does not touch the memory, so it has no bandwidth figure.
+      RegisterBenchmark(CaseName({"empty", DtypeName(dtype), size}),
+                        [numel, options]() -> BenchBody {
+                          return [numel, options]() {
+                            DoNotOptimize(at::empty({numel}, options));
+                          };
+                        });
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
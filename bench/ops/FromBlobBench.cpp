@@ -0,0 +1,47 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/from_blob.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+// from_blob only wraps memory, so its cost must not depend on the size of
+// the buffer; the size sweep makes a hidden copy show up immediately.
+BENCH_SUITE(FromBlobBench) {
+  for (at::ScalarType dtype : {at::kFloat, at::kLong}) {
+    at::TensorOptions options = at::TensorOptions().dtype(dtype);
+    for (int64_t numel : SweepSizes()) {
+      std::string size = std::to_string(numel);
+      RegisterBenchmark(
+          CaseName({"from_blob", DtypeName(dtype), size}),
+          [dtype, numel, options]() -> BenchBody {
+            auto buffer = std::shared_ptr<char[]>(
+                new char[numel * DtypeSize(dtype)]());  // NOLINT
+            return [buffer, numel, options]() {
+              DoNotOptimize(at::from_blob(buffer.get(), {numel}, options));
+            };
+          });
+      RegisterBenchmark(
+          CaseName({"from_blob_strided", DtypeName(dtype), size}),
+          [dtype, numel, options]() -> BenchBody {
+            auto buffer = std::shared_ptr<char[]>(
+                new char[numel * DtypeSize(dtype)]());  // NOLINT
+            int64_t rows = numel / 16;
+            return [buffer, rows, options]() {
+              DoNotOptimize(
+                  at::from_blob(buffer.get(), {rows, 16}, {16, 1}, options));
+            };
+          });
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
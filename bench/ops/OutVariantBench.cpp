@@ -0,0 +1,225 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+const std::vector<int64_t>& OutVariantSizes() {
+  static const std::vector<int64_t> sizes = {1024, 64 * 1024, 4 << 20};
+  return sizes;
+}
+
+// The allocating call and its preallocated forms share a name except for
+// the variant part, e.g. "abs/alloc/float32/1024" and
+// "abs/out/float32/1024".
+std::string VariantCase(const std::string& op,
+                        const std::string& variant,
+                        int64_t numel) {
+  return CaseName({op, variant, "float32", std::to_string(numel)});
+}
+
+// Prints, for every out or in-place case, the time and allocations relative
+// to the allocating call of the same op and size.
+void PrintOutVariantSummary(std::vector<BenchResult>* results) {
+  std::map<std::string, const BenchResult*> by_name;
+  for (const BenchResult& result : *results) {
+    by_name[result.name] = &result;
+  }
+  char line[256];
+  bool printed_header = false;
+  for (BenchResult& result : *results) {
+    size_t first = result.name.find('/');
+    size_t second = result.name.find('/', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string variant = result.name.substr(first + 1, second - first - 1);
+    if (variant == "alloc") {
+      continue;
+    }
+    std::string alloc_name = result.name.substr(0, first) + "/alloc" +
+                             result.name.substr(second);
+    auto it = by_name.find(alloc_name);
+    if (it == by_name.end() || result.median_ns <= 0) {
+      continue;
+    }
+    const BenchResult& alloc = *it->second;
+    double speedup = alloc.median_ns / result.median_ns;
+    result.counters["speedup_vs_alloc"] = speedup;
+    auto allocs = result.counters.find("allocs_per_iter");
+    auto alloc_allocs = alloc.counters.find("allocs_per_iter");
+    if (!printed_header) {
+      std::snprintf(line,
+                    sizeof(line),
+                    "%-40s %10s %14s %14s",
+                    "out variant",
+                    "speedup",
+                    "allocs/iter",
+                    "alloc allocs");
+      std::cout << "\n" << line << std::endl;
+      printed_header = true;
+    }
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-40s %10.2f %14.2f %14.2f",
+        result.name.c_str(),
+        speedup,
+        allocs == result.counters.end() ? 0.0 : allocs->second,
+        alloc_allocs == alloc.counters.end() ? 0.0 : alloc_allocs->second);
+    std::cout << line << std::endl;
+  }
+}
+
+}  // namespace
+
+// Steady-state loops of allocating calls against their _out and in-place
+// forms writing into a preallocated output. Besides time, allocs_per_iter
+// of an out or in-place case should be (close to) zero: anything left is
+// allocated inside the compat layer and defeats reusing the output.
+BENCH_SUITE(OutVariantBench) {
+  for (int64_t numel : OutVariantSizes()) {
+    int64_t bytes = numel * DtypeSize(at::kFloat);
+
+    RegisterBenchmark(
+        VariantCase("abs", "alloc", numel),
+        [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel}, at::kFloat);
+          return [input]() { DoNotOptimize(at::abs(input)); };
+        },
+        2 * bytes);
+    RegisterBenchmark(
+        VariantCase("abs", "out", numel),
+        [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel}, at::kFloat);
+          at::Tensor output = at::empty({numel}, at::kFloat);
+          return [input, output]() mutable {
+            DoNotOptimize(at::abs_out(output, input));
+          };
+        },
+        2 * bytes);
+    RegisterBenchmark(
+        VariantCase("abs", "inplace", numel),
+        [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel}, at::kFloat);
+          return [input]() mutable { DoNotOptimize(input.abs_()); };
+        },
+        2 * bytes);
+
+    // Four inputs of a quarter of the output each.
+    RegisterBenchmark(
+        VariantCase("cat", "alloc", numel),
+        [numel]() -> BenchBody {
+          std::vector<at::Tensor> inputs(4,
+                                         MakeInput({numel / 4}, at::kFloat));
+          return [inputs]() { DoNotOptimize(at::cat(inputs, 0)); };
+        },
+        2 * bytes);
+    RegisterBenchmark(
+        VariantCase("cat", "out", numel),
+        [numel]() -> BenchBody {
+          std::vector<at::Tensor> inputs(4,
+                                         MakeInput({numel / 4}, at::kFloat));
+          at::Tensor output = at::empty({numel / 4 * 4}, at::kFloat);
+          return [inputs, output]() mutable {
+            DoNotOptimize(at::cat_out(output, inputs, 0));
+          };
+        },
+        2 * bytes);
+
+    // Row sums of a {numel / 64, 64} matrix.
+    RegisterBenchmark(
+        VariantCase("sum_dim", "alloc", numel),
+        [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel / 64, 64}, at::kFloat);
+          return [input]() { DoNotOptimize(at::sum(input, {1}, false)); };
+        },
+        bytes);
+    RegisterBenchmark(
+        VariantCase("sum_dim", "out", numel),
+        [numel]() -> BenchBody {
+          at::Tensor input = MakeInput({numel / 64, 64}, at::kFloat);
+          at::Tensor output = at::empty({numel / 64}, at::kFloat);
+          return [input, output]() mutable {
+            DoNotOptimize(at::sum_out(output, input, {1}, false));
+          };
+        },
+        bytes);
+
+    at::TensorOptions options = at::TensorOptions().dtype(at::kFloat);
+    RegisterBenchmark(
+        VariantCase("arange", "alloc", numel),
+        [numel, options]() -> BenchBody {
+          return [numel, options]() {
+            DoNotOptimize(at::arange(numel, options));
+          };
+        },
+        bytes);
+    RegisterBenchmark(
+        VariantCase("arange", "out", numel),
+        [numel]() -> BenchBody {
+          at::Tensor output = at::empty({numel}, at::kFloat);
+          return [output, numel]() mutable {
+            DoNotOptimize(at::arange_out(output, numel));
+          };
+        },
+        bytes);
+
+    RegisterBenchmark(
+        VariantCase("zeros", "alloc", numel),
+        [numel, options]() -> BenchBody {
+          return [numel, options]() {
+            DoNotOptimize(at::zeros({numel}, options));
+          };
+        },
+        bytes);
+    RegisterBenchmark(
+        VariantCase("zeros", "out", numel),
+        [numel]() -> BenchBody {
+          at::Tensor output = at::empty({numel}, at::kFloat);
+          return [output, numel]() mutable {
+            DoNotOptimize(at::zeros_out(output, {numel}));
+          };
+        },
+        bytes);
+
+    RegisterBenchmark(
+        VariantCase("full", "alloc", numel),
+        [numel, options]() -> BenchBody {
+          return [numel, options]() {
+            DoNotOptimize(at::full({numel}, 1.5, options));
+          };
+        },
+        bytes);
+    RegisterBenchmark(
+        VariantCase("full", "out", numel),
+        [numel]() -> BenchBody {
+          at::Tensor output = at::empty({numel}, at::kFloat);
+          return [output, numel]() mutable {
+            DoNotOptimize(at::full_out(output, {numel}, 1.5));
+          };
+        },
+        bytes);
+  }
+  RegisterSummary(PrintOutVariantSummary);
+}
+
+}  // namespace bench
+}  // namespace at
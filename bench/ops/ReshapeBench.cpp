@@ -0,0 +1,59 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/empty_like.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/zeros_like.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(ReshapeBench) {
+  for (at::ScalarType dtype : {at::kFloat, at::kLong}) {
+    for (int64_t numel : SweepSizes()) {
+      std::string size = std::to_string(numel);
+      int64_t bytes = numel * DtypeSize(dtype);
+      // Reshaping a contiguous tensor is metadata only.
+      RegisterBenchmark(CaseName({"reshape_view", DtypeName(dtype), size}),
+                        [dtype, numel]() -> BenchBody {
+                          at::Tensor input = MakeInput({numel / 16, 16}, dtype);
+                          return [input, numel]() {
+                            DoNotOptimize(at::reshape(input, {16, numel / 16}));
+                          };
+                        });
+      // Reshaping a transposed tensor has to copy.
+      RegisterBenchmark(
+          CaseName({"reshape_copy", DtypeName(dtype), size}),
+          [dtype, numel]() -> BenchBody {
+            at::Tensor input =
+                MakeInput({numel / 16, 16}, dtype).transpose(0, 1);
+            return [input, numel]() {
+              DoNotOptimize(at::reshape(input, {numel}));
+            };
+          },
+          2 * bytes);
+      RegisterBenchmark(CaseName({"empty_like", DtypeName(dtype), size}),
+                        [dtype, numel]() -> BenchBody {
+                          at::Tensor input = MakeInput({numel}, dtype);
+                          return [input]() {
+                            DoNotOptimize(at::empty_like(input));
+                          };
+                        });
+      RegisterBenchmark(
+          CaseName({"zeros_like", DtypeName(dtype), size}),
+          [dtype, numel]() -> BenchBody {
+            at::Tensor input = MakeInput({numel}, dtype);
+            return [input]() { DoNotOptimize(at::zeros_like(input)); };
+          },
+          bytes);
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,49 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/sum.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+
+BENCH_SUITE(SumBench) {
+  for (at::ScalarType dtype : {at::kFloat, at::kDouble, at::kInt, at::kLong}) {
+    for (int64_t numel : SweepSizes()) {
+      std::string size = std::to_string(numel);
+      int64_t bytes = numel * DtypeSize(dtype);
+      RegisterBenchmark(
+          CaseName({"sum", DtypeName(dtype), size}),
+          [dtype, numel]() -> BenchBody {
+            at::Tensor input = MakeInput({numel}, dtype);
+            return [input]() { DoNotOptimize(at::sum(input)); };
+          },
+          bytes);
+      RegisterBenchmark(
+          CaseName({"sum_dtype", DtypeName(dtype), size}),
+          [dtype, numel]() -> BenchBody {
+            at::Tensor input = MakeInput({numel}, dtype);
+            return [input]() { DoNotOptimize(at::sum(input, at::kDouble)); };
+          },
+          bytes);
+      for (int64_t dim : {0, 1}) {
+        RegisterBenchmark(
+            CaseName({"sum_dim" + std::to_string(dim), DtypeName(dtype), size}),
+            [dtype, numel, dim]() -> BenchBody {
+              at::Tensor input = MakeInput({numel / 16, 16}, dtype);
+              return [input, dim]() {
+                DoNotOptimize(at::sum(input, {dim}, false));
+              };
+            },
+            bytes);
+      }
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,113 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "benchmark.h"
+
+namespace at {
+namespace bench {
+namespace {
+
+// Input sizes in bytes, from L1-resident to far beyond the last level cache.
+const std::vector<int64_t>& ReductionBytes() {
+  static const std::vector<int64_t> bytes = {int64_t{1} << 10,
+                                             int64_t{256} << 10,
+                                             int64_t{16} << 20,
+                                             int64_t{256} << 20};
+  return bytes;
+}
+
+// A {rows, cols} shape with numel elements and cols a power of two close
+// to sqrt(numel), so both inner and outer reductions have real work.
+std::vector<int64_t> MatrixShape(int64_t numel) {
+  int64_t cols = int64_t{1}
+                 << static_cast<int>(std::log2(static_cast<double>(numel)) / 2);
+  return {numel / cols, cols};
+}
+
+enum class Variant { kAll, kAllDouble, kInner, kInnerKeepdim, kOuter, kOut };
+
+const char* VariantName(Variant variant) {
+  switch (variant) {
+    case Variant::kAll:
+      return "sum";
+    case Variant::kAllDouble:
+      return "sum_to_float64";
+    case Variant::kInner:
+      return "sum_inner";
+    case Variant::kInnerKeepdim:
+      return "sum_inner_keepdim";
+    case Variant::kOuter:
+      return "sum_outer";
+    case Variant::kOut:
+      return "sum_out_inner";
+  }
+  return "unknown";
+}
+
+BenchBody MakeBody(Variant variant, at::Tensor input) {
+  switch (variant) {
+    case Variant::kAll:
+      return [input]() { DoNotOptimize(at::sum(input)); };
+    case Variant::kAllDouble:
+      return [input]() { DoNotOptimize(at::sum(input, at::kDouble)); };
+    case Variant::kInner:
+      return [input]() { DoNotOptimize(at::sum(input, {1}, false)); };
+    case Variant::kInnerKeepdim:
+      return [input]() { DoNotOptimize(at::sum(input, {1}, true)); };
+    case Variant::kOuter:
+      return [input]() { DoNotOptimize(at::sum(input, {0}, false)); };
+    case Variant::kOut: {
+      at::Tensor output = at::zeros({input.size(0)}, input.scalar_type());
+      return [input, output]() mutable {
+        DoNotOptimize(at::sum_out(output, input, {1}, false));
+      };
+    }
+  }
+  return []() {};
+}
+
+}  // namespace
+
+// at::sum variants over inner (contiguous) and outer dims at 1..N intra-op
+// threads. The summary reports speedup and parallel efficiency against one
+// thread for every variant, dtype and size.
+BENCH_SUITE(SumScalingBench) {
+  const std::vector<Variant> variants = {Variant::kAll,
+                                         Variant::kAllDouble,
+                                         Variant::kInner,
+                                         Variant::kInnerKeepdim,
+                                         Variant::kOuter,
+                                         Variant::kOut};
+  for (Variant variant : variants) {
+    for (at::ScalarType dtype : {at::kFloat, at::kDouble, at::kInt}) {
+      for (int64_t bytes : ReductionBytes()) {
+        int64_t numel = bytes / DtypeSize(dtype);
+        std::vector<int64_t> shape = MatrixShape(numel);
+        for (int threads : ThreadSweep()) {
+          RegisterBenchmark(
+              CaseName({VariantName(variant),
+                        DtypeName(dtype),
+                        std::to_string(bytes) + "B",
+                        "threads" + std::to_string(threads)}),
+              [variant, dtype, shape, threads]() -> BenchBody {
+                at::set_num_threads(threads);
+                return MakeBody(variant, MakeInput(shape, dtype));
+              },
+              shape[0] * shape[1] * DtypeSize(dtype));
+        }
+      }
+    }
+  }
+  RegisterThreadScalingSummary();
+}
+
+}  // namespace bench
+}  // namespace at
@@ -0,0 +1,99 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/ones.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "benchmark.h"
+#if USE_PADDLE_API
+#include "paddle/extension.h"
+#endif
+
+// Cold-start probe, run through tools/startup_bench.py. It prints one JSON
+// line with the time from exec to this executable's first constructor (ELF
+// loading, relocation and every shared library's static initializers), from
+// there to main, and the latency of the first and second at::ones call.
+// The launcher passes the CLOCK_MONOTONIC time right before exec in
+// STARTUP_BENCH_EXEC_NS.
+
+namespace {
+
+int64_t MonotonicNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return int64_t{ts.tv_sec} * 1000000000 + ts.tv_nsec;
+}
+
+int64_t g_first_ctor_ns = 0;
+
+// Priority 101 runs before this executable's other static initializers,
+// but after the initializers of all shared libraries it depends on.
+__attribute__((constructor(101))) void RecordFirstConstructor() {
+  g_first_ctor_ns = MonotonicNs();
+}
+
+// Process start from /proc/self/stat, used when not started by the
+// launcher. Only clock-tick resolution (usually 10 ms).
+int64_t ProcStartNs() {
+  std::ifstream stat("/proc/self/stat");
+  std::string content((std::istreambuf_iterator<char>(stat)),
+                      std::istreambuf_iterator<char>());
+  // Skip "pid (comm)", comm may contain spaces.
+  size_t pos = content.rfind(')');
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  std::istringstream fields(content.substr(pos + 2));
+  std::string field;
+  // starttime is field 22; fields(…) starts at field 3.
+  for (int i = 3; i <= 22 && fields >> field; ++i) {
+  }
+  int64_t ticks = std::atoll(field.c_str());
+  timespec boot;
+  clock_gettime(CLOCK_BOOTTIME, &boot);
+  int64_t boot_ns = int64_t{boot.tv_sec} * 1000000000 + boot.tv_nsec;
+  int64_t start_since_boot_ns = ticks * (1000000000 / sysconf(_SC_CLK_TCK));
+  // Translate from CLOCK_BOOTTIME to CLOCK_MONOTONIC.
+  return MonotonicNs() - (boot_ns - start_since_boot_ns);
+}
+
+}  // namespace
+
+int main() {
+  int64_t main_ns = MonotonicNs();
+
+  const char* exec_env = std::getenv("STARTUP_BENCH_EXEC_NS");
+  int64_t exec_ns = exec_env ? std::atoll(exec_env) : ProcStartNs();
+
+  int64_t start = MonotonicNs();
+  at::Tensor first = at::ones({2, 3}, at::kFloat);
+  int64_t first_ns = MonotonicNs() - start;
+  at::bench::DoNotOptimize(first);
+
+  start = MonotonicNs();
+  at::Tensor second = at::ones({2, 3}, at::kFloat);
+  int64_t second_ns = MonotonicNs() - start;
+  at::bench::DoNotOptimize(second);
+
+  std::printf(
+      "{\"backend\": \"%s\", \"exec_source\": \"%s\", "
+      "\"exec_to_first_ctor_ms\": %.3f, \"first_ctor_to_main_ms\": %.3f, "
+      "\"exec_to_main_ms\": %.3f, \"first_ones_us\": %.3f, "
+      "\"second_ones_us\": %.3f}\n",
+      at::bench::kBackendName,
+      exec_env ? "launcher" : "proc_stat",
+      (g_first_ctor_ns - exec_ns) / 1e6,
+      (main_ns - g_first_ctor_ns) / 1e6,
+      (main_ns - exec_ns) / 1e6,
+      first_ns / 1e3,
+      second_ns / 1e3);
+  return 0;
+}
@@ -17,13 +17,74 @@ function(
       ${DEPS_LIBRARIES} ${Python3_LIBRARIES})
     target_include_directories(${_test_name} PRIVATE ${Python3_INCLUDE_DIRS})
     target_include_directories(${_test_name} PRIVATE ${INCLUDE_DIR})
+    target_include_directories(${_test_name} PRIVATE ${PROJECT_SOURCE_DIR}/src)
     message(STATUS "include dir: ${INCLUDE_DIR}")
     target_compile_definitions(${_test_name}
                                PRIVATE USE_PADDLE_API=${USE_PADDLE_API})
     message(STATUS "USE_PADDLE_API: ${USE_PADDLE_API}")
-    add_test(NAME ${_test_name} COMMAND ${_test_name})
-    set_tests_properties(${_test_name} PROPERTIES TIMEOUT 5)
+    if(NOT ALL_API_TESTS_ONLY)
+      add_test(NAME ${_test_name} COMMAND ${_test_name})
+      set_tests_properties(${_test_name} PROPERTIES TIMEOUT 5 LABELS per_file)
+    endif()
     set_target_properties(${_test_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
                                                    "${TARGET_FOLDER}")
   endforeach()
+
+  # All test files in one binary, so the backend libraries and libpython are
+  # loaded and relocated once per suite instead of once per file. It is
+  # always built but only one of the two sets is registered with CTest, so a
+  # plain ctest never runs every test twice.
+  set(_all_name ${BIN_PREFIX}${EXE_TARGET_NAME})
+  add_executable(${_all_name} ${TEST_SRC_FILES} ${TEST_BASE_FILES})
+  add_dependencies(${_all_name} "googletest.git")
+  target_link_libraries(
+    ${_all_name} gtest gtest_main ${CMAKE_THREAD_LIBS_INIT} ${DEPS_LIBRARIES}
+    ${Python3_LIBRARIES})
+  target_include_directories(${_all_name} PRIVATE ${Python3_INCLUDE_DIRS})
+  target_include_directories(${_all_name} PRIVATE ${INCLUDE_DIR})
+  target_include_directories(${_all_name} PRIVATE ${PROJECT_SOURCE_DIR}/src)
+  target_compile_definitions(${_all_name}
+                             PRIVATE USE_PADDLE_API=${USE_PADDLE_API})
+  if(ALL_API_TESTS_ONLY)
+    add_test(NAME ${_all_name} COMMAND ${_all_name})
+    set_tests_properties(${_all_name} PROPERTIES TIMEOUT 60 LABELS
+                                                 ${EXE_TARGET_NAME})
+  endif()
+  set_target_properties(${_all_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
+                                                "${TARGET_FOLDER}")
+endfunction()
+
+function(
+  create_paddle_benchmarks
+  BIN_PREFIX
+  BENCH_SRC_FILES
+  TARGET_FOLDER
+  DEPS_LIBRARIES
+  INCLUDE_DIR
+  USE_PADDLE_API
+  BASE_FILES)
+
+  foreach(_bench_file ${BENCH_SRC_FILES})
+    get_filename_component(_file_name ${_bench_file} NAME_WE)
+    # AbsBench.cpp -> ${BIN_PREFIX}Abs
+    string(REGEX REPLACE "Bench$" "" _file_name ${_file_name})
+    set(_bench_name ${BIN_PREFIX}${_file_name})
+    add_executable(${_bench_name} ${_bench_file} ${BASE_FILES})
+    target_link_libraries(${_bench_name} ${CMAKE_THREAD_LIBS_INIT}
+                          ${DEPS_LIBRARIES} ${Python3_LIBRARIES})
+    target_include_directories(${_bench_name} PRIVATE ${Python3_INCLUDE_DIRS})
+    target_include_directories(${_bench_name} PRIVATE ${INCLUDE_DIR})
+    target_include_directories(
+      ${_bench_name} PRIVATE ${PROJECT_SOURCE_DIR}/bench/common
+                             ${PROJECT_SOURCE_DIR}/src)
+    target_compile_definitions(${_bench_name}
+                               PRIVATE USE_PADDLE_API=${USE_PADDLE_API})
+    # The timing loops and accessor calls are inlined into the benchmark
+    # binary, so build them optimized even in the default build type.
+    if(NOT MSVC)
+      target_compile_options(${_bench_name} PRIVATE -O2)
+    endif()
+    set_target_properties(${_bench_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
+                                                    "${TARGET_FOLDER}")
+  endforeach()
 endfunction()
@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""
+api_matrix.py - 根据头文件、测试与 benchmark 结果生成 API 兼容性矩阵
+
+用法:
+    python coverage/api_matrix.py <paddle TensorBody.h> <build_dir>
+        [--torch-header <torch TensorBody.h>] [--output doc/tensor_body.md]
+        [--no-bench] [-- benchmark 参数...]
+
+- API 列表: 与 coverage_analysis.py 相同，用 get_cpp_functions 从头文件中提取；
+  给出 torch 头文件时，torch 有而 paddle 没有的 API 记为未支持
+- 测试用例状态: test/ 下的源文件中是否调用了该 API
+- 耗时比 / 额外分配: 运行 <build_dir>/{torch,paddle}/<backend>_bench_*，
+  用例名的任一段与 API 同名即归入该 API，取各用例 paddle/torch 中位数耗时比的中位数，
+  以及 paddle 比 torch 每次调用多出的 malloc 次数
+- 零拷贝: 运行 paddle_ZeroCopyTest，读取 gtest XML 中的 copied_bytes 属性
+- 优先级和备注沿用输出文件中已有的内容，❌ (不准备支持) 的标记也会保留
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ET
+
+from coverage_analysis import get_cpp_functions
+
+ROOT_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SUPPORTED = "✅"
+UNSUPPORTED = "❌"
+TODO = "- [ ]"
+# 自带 main、输出格式不同的 benchmark
+SKIPPED_BENCHES = {"Startup", "DiffWorkload"}
+
+HEADER = """
+##### tensor_body.h头文件API兼容情况
+
+
+##### tensor_body.h 头文件 API 兼容性
+
+本表由 `coverage/api_matrix.py` 生成，优先级和备注列可以手工修改，重新生成时会保留。
+
+✅ 表示已经支持
+❌ 表示不准备支持
+
+- 耗时比: paddle / torch 的中位数耗时比，来自 `bench/` 中包含该 API 的所有用例
+- 额外分配: paddle 比 torch 每次调用多出的 malloc 次数
+- 零拷贝: `ZeroCopyTest` 中该 API 的结果是否与输入共享内存
+
+**按照首字母进行排序**
+
+"""
+
+COLUMNS = [
+    "torch API",
+    "paddle API 兼容性",
+    "测试用例状态",
+    "耗时比 (p/t)",
+    "额外分配/次",
+    "零拷贝",
+    "优先级",
+    "备注",
+]
+
+
+def normalize(name):
+    return name.replace("_", "").lower()
+
+
+def header_apis(header):
+    """头文件中的公开 API 名（去掉构造函数、运算符和 _ 开头的内部函数）"""
+    names = set()
+    for _, name, _ in get_cpp_functions(header):
+        if name.startswith("_") or name.startswith("operator"):
+            continue
+        if name in ("Tensor", "TensorBase"):
+            continue
+        names.add(name)
+    return names
+
+
+def tested_apis(apis):
+    """在 test/ 的源文件中以 .api( 或 ::api( 形式出现过的 API"""
+    sources = ""
+    pattern = os.path.join(ROOT_PATH, "test", "**", "*.cpp")
+    for path in glob.glob(pattern, recursive=True):
+        with open(path, "r", encoding="utf-8", errors="ignore") as f:
+            sources += f.read()
+    tested = set()
+    for api in apis:
+        if re.search(r"(\.|::)" + re.escape(api) + r"\s*[(<]", sources):
+            tested.add(api)
+    return tested
+
+
+def run_benches(build_dir, backend, out_dir, extra_args):
+    """运行该后端的全部 benchmark，返回 {"<bench>/<case>": result}"""
+    results = {}
+    prefix = os.path.join(build_dir, backend, f"{backend}_bench_")
+    for binary in sorted(glob.glob(prefix + "*")):
+        name = binary[len(prefix) :]
+        if name in SKIPPED_BENCHES or not os.access(binary, os.X_OK):
+            continue
+        json_path = os.path.join(out_dir, f"{backend}_{name}.json")
+        print(f"running {os.path.basename(binary)}", flush=True)
+        subprocess.run(
+            [binary, f"--json={json_path}", *extra_args],
+            check=True,
+            stdout=subprocess.DEVNULL,
+        )
+        with open(json_path, "r", encoding="utf-8") as f:
+            for result in json.load(f)["results"]:
+                results[f"{name}/{result['name']}"] = result
+    return results
+
+
+def allocs_per_call(result):
+    counters = result.get("counters", {})
+    if "allocs_per_item" in counters:
+        return counters["allocs_per_item"]
+    if "allocs_per_iter" in counters:
+        return counters["allocs_per_iter"] / max(result["items_per_iter"], 1)
+    return None
+
+
+def match_case_api(key, apis):
+    """
+    第一段是 benchmark 名，其余各段依次尝试匹配 API 名；
+    段名不是 API 时逐个去掉 "_xxx" 后缀再试，例如 toType_double -> toType
+    """
+    for part in key.split("/")[1:]:
+        while part:
+            if part in apis:
+                return part
+            if "_" not in part.strip("_"):
+                break
+            part = part.rsplit("_", 1)[0]
+    return None
+
+
+def bench_columns(apis, torch_results, paddle_results):
+    """返回 {api: (耗时比, 额外分配/次)}"""
+    ratios = {}
+    extra_allocs = {}
+    for key, paddle in paddle_results.items():
+        torch = torch_results.get(key)
+        if torch is None:
+            continue
+        api = match_case_api(key, apis)
+        if api is None:
+            continue
+        if torch["median_ns"] > 0:
+            ratios.setdefault(api, []).append(
+                paddle["median_ns"] / torch["median_ns"]
+            )
+        p_allocs, t_allocs = allocs_per_call(paddle), allocs_per_call(torch)
+        if p_allocs is not None and t_allocs is not None:
+            extra_allocs.setdefault(api, []).append(p_allocs - t_allocs)
+    columns = {}
+    for api in apis:
+        ratio = ratios.get(api)
+        extra = extra_allocs.get(api)
+        columns[api] = (
+            statistics.median(ratio) if ratio else None,
+            statistics.median(extra) if extra else None,
+        )
+    return columns
+
+
+def zero_copy_results(build_dir, apis):
+    """返回 {api: 是否零拷贝}，由 ZeroCopyTest 用例名的前缀对应到 API"""
+    binary = os.path.join(build_dir, "paddle", "paddle_ZeroCopyTest")
+    if not os.path.exists(binary):
+        return {}
+    with tempfile.TemporaryDirectory() as out_dir:
+        xml_path = os.path.join(out_dir, "zero_copy.xml")
+        subprocess.run(
+            [binary, f"--gtest_output=xml:{xml_path}"],
+            check=False,
+            stdout=subprocess.DEVNULL,
+        )
+        if not os.path.exists(xml_path):
+            return {}
+        tree = ET.parse(xml_path)
+    # 较长的 API 名优先，避免 "to" 抢先匹配 "toType"
+    ordered = sorted(apis, key=lambda api: -len(api))
+    zero_copy = {}
+    for case in tree.iter("testcase"):
+        copied = None
+        for prop in case.iter("property"):
+            if prop.get("name") == "copied_bytes":
+                copied = int(prop.get("value"))
+        # 有些 gtest 版本把 RecordProperty 写成 testcase 的属性
+        if copied is None and case.get("copied_bytes") is not None:
+            copied = int(case.get("copied_bytes"))
+        if copied is None:
+            continue
+        test_name = normalize(case.get("name", ""))
+        for api in ordered:
+            if test_name.startswith(normalize(api)):
+                zero_copy[api] = zero_copy.get(api, True) and copied == 0
+                break
+    return zero_copy
+
+
+def read_existing(path):
+    """读取已有表格中的 {api: {列名: 值}}"""
+    rows = {}
+    if not os.path.exists(path):
+        return rows
+    with open(path, "r", encoding="utf-8") as f:
+        lines = [line.strip() for line in f if line.strip().startswith("|")]
+    if len(lines) < 2:
+        return rows
+    columns = [c.strip() for c in lines[0].strip("|").split("|")]
+    for line in lines[2:]:
+        cells = [c.strip() for c in line.strip("|").split("|")]
+        row = dict(zip(columns, cells))
+        api = row.get("torch API", "").strip("`")
+        if api:
+            rows[api] = row
+    return rows
+
+
+def format_ratio(value):
+    return "-" if value is None else f"{value:.2f}"
+
+
+def format_allocs(value):
+    return "-" if value is None else f"{value:+.1f}"
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("paddle_header")
+    parser.add_argument("build_dir")
+    parser.add_argument("--torch-header", default="")
+    parser.add_argument(
+        "--output", default=os.path.join(ROOT_PATH, "doc", "tensor_body.md")
+    )
+    parser.add_argument(
+        "--no-bench", action="store_true", help="不运行 benchmark"
+    )
+    # "--" 之后的参数原样透传给 benchmark 二进制
+    argv = sys.argv[1:]
+    bench_args = []
+    if "--" in argv:
+        split = argv.index("--")
+        argv, bench_args = argv[:split], argv[split + 1 :]
+    args = parser.parse_args(argv)
+
+    if not os.path.exists(args.paddle_header):
+        print(f"Error: header not found: {args.paddle_header}")
+        sys.exit(1)
+    paddle_apis = header_apis(args.paddle_header)
+    apis = set(paddle_apis)
+    if args.torch_header:
+        apis |= header_apis(args.torch_header)
+    existing = read_existing(args.output)
+    apis |= set(existing)
+
+    tested = tested_apis(apis)
+    perf = {}
+    if not args.no_bench:
+        with tempfile.TemporaryDirectory() as out_dir:
+            torch_results = run_benches(
+                args.build_dir, "torch", out_dir, bench_args
+            )
+            paddle_results = run_benches(
+                args.build_dir, "paddle", out_dir, bench_args
+            )
+        perf = bench_columns(apis, torch_results, paddle_results)
+    zero_copy = zero_copy_results(args.build_dir, apis)
+
+    lines = [
+        "| " + " | ".join(COLUMNS) + " |",
+        "|" + "|".join("-" * (len(c) + 2) for c in COLUMNS) + "|",
+    ]
+    for api in sorted(apis, key=str.lower):
+        old = existing.get(api, {})
+        if old.get("paddle API 兼容性") == UNSUPPORTED:
+            support = test = UNSUPPORTED
+        else:
+            support = SUPPORTED if api in paddle_apis else TODO
+            test = SUPPORTED if api in tested else TODO
+        ratio, extra = perf.get(api, (None, None))
+        if api in zero_copy:
+            copy = SUPPORTED if zero_copy[api] else UNSUPPORTED
+        else:
+            copy = "-"
+        cells = [
+            f"`{api}`",
+            support,
+            test,
+            format_ratio(ratio),
+            format_allocs(extra),
+            copy,
+            old.get("优先级", ""),
+            old.get("备注", ""),
+        ]
+        lines.append("| " + " | ".join(cells) + " |")
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(HEADER + "\n".join(lines) + "\n")
+    print(f"wrote {len(apis)} APIs to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+#include "alloc_tracker.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <cstddef>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && \
+    !defined(__SANITIZE_THREAD__)
+#define ALLOC_TRACKER_HOOKS 1
+#else
+#define ALLOC_TRACKER_HOOKS 0
+#endif
+
+namespace at {
+namespace test {
+namespace {
+
+// Plain globals with constant initialization: the hooks may run before any
+// dynamic initializer of this file.
+std::atomic<int> g_active_scopes{0};
+std::atomic<int64_t> g_allocs{0};
+std::atomic<int64_t> g_bytes{0};
+std::atomic<int64_t> g_frees{0};
+
+inline void RecordAlloc(size_t size) {
+  if (g_active_scopes.load(std::memory_order_relaxed) > 0) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+  }
+}
+
+inline void RecordFree(void* ptr) {
+  if (ptr != nullptr && g_active_scopes.load(std::memory_order_relaxed) > 0) {
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+AllocStats Current() {
+  AllocStats stats;
+  stats.allocs = g_allocs.load(std::memory_order_relaxed);
+  stats.bytes = g_bytes.load(std::memory_order_relaxed);
+  stats.frees = g_frees.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace
+
+AllocScope::AllocScope() {
+  g_active_scopes.fetch_add(1, std::memory_order_relaxed);
+  start_ = Current();
+}
+
+AllocScope::~AllocScope() {
+  g_active_scopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AllocStats AllocScope::Stats() const {
+  AllocStats now = Current();
+  now.allocs -= start_.allocs;
+  now.bytes -= start_.bytes;
+  now.frees -= start_.frees;
+  return now;
+}
+
+bool AllocTrackingAvailable() { return ALLOC_TRACKER_HOOKS; }
+
+}  // namespace test
+}  // namespace at
+
+#if ALLOC_TRACKER_HOOKS
+// glibc keeps its allocator reachable under these names, so the hooks below
+// can forward to it without dlsym (which itself allocates).
+extern "C" {
+void* __libc_malloc(size_t size) noexcept;
+void __libc_free(void* ptr) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* ptr, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+
+void* malloc(size_t size) noexcept {
+  at::test::RecordAlloc(size);
+  return __libc_malloc(size);
+}
+
+void free(void* ptr) noexcept {
+  at::test::RecordFree(ptr);
+  __libc_free(ptr);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  at::test::RecordAlloc(count * size);
+  return __libc_calloc(count, size);
+}
+
+// Only a realloc that moves the block is counted, as one allocation plus
+// one free of the old block. Growing or shrinking in place costs no new
+// allocation.
+void* realloc(void* ptr, size_t size) noexcept {
+  void* result = __libc_realloc(ptr, size);
+  if (result != nullptr && result != ptr) {
+    at::test::RecordAlloc(size);
+    at::test::RecordFree(ptr);
+  } else if (result == nullptr && size == 0) {
+    // realloc(ptr, 0) frees ptr in glibc.
+    at::test::RecordFree(ptr);
+  }
+  return result;
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+  at::test::RecordAlloc(size);
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  at::test::RecordAlloc(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void*) != 0 ||
+      (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  at::test::RecordAlloc(size);
+  void* ptr = __libc_memalign(alignment, size);
+  if (ptr == nullptr && size != 0) {
+    return ENOMEM;
+  }
+  *memptr = ptr;
+  return 0;
+}
+}  // extern "C"
+#endif  // ALLOC_TRACKER_HOOKS
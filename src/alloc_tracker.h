@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+namespace test {
+
+struct AllocStats {
+  int64_t allocs = 0;
+  int64_t bytes = 0;
+  int64_t frees = 0;
+};
+
+// Counts heap allocations made while at least one AllocScope is alive.
+//
+// alloc_tracker.cpp interposes the glibc malloc family in the executable.
+// The default global operator new, libtorch's c10 CPU allocator and Paddle's
+// CPU allocators all end up in malloc/posix_memalign, so one hook sees both
+// backends. Allocations served from a backend's own cache (e.g. Paddle's
+// auto-growth allocator after warmup) never reach malloc and are not
+// counted, which matches their real cost. A realloc counts only when it
+// moves the block. Counters are process wide, so allocations of backend
+// worker threads are included.
+class AllocScope {
+ public:
+  AllocScope();
+  ~AllocScope();
+
+  AllocScope(const AllocScope&) = delete;
+  AllocScope& operator=(const AllocScope&) = delete;
+
+  // Allocations made since this scope was created.
+  AllocStats Stats() const;
+
+ private:
+  AllocStats start_;
+};
+
+// False when the hooks are not compiled in (non-glibc, sanitizer builds); in
+// that case every AllocScope reports zero.
+bool AllocTrackingAvailable();
+
+}  // namespace test
+}  // namespace at
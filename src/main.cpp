@@ -1,4 +1,8 @@
+#include <cstring>
+#include <string>
+
 #include "gtest/gtest.h"
+#include "perf_listener.h"
 #if USE_PADDLE_API
 #include "paddle/extension.h"
 #endif
@@ -6,6 +10,17 @@
 int main(int argc, char** argv) {  // NOLINT
   testing::InitGoogleTest(&argc, argv);
 
+  // --perf_json=<path>: write per-test wall/CPU time, peak RSS, page faults
+  // and heap allocations to <path>.
+  const char kPerfJsonFlag[] = "--perf_json=";
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], kPerfJsonFlag, sizeof(kPerfJsonFlag) - 1) == 0) {
+      std::string json_path = argv[i] + sizeof(kPerfJsonFlag) - 1;
+      testing::UnitTest::GetInstance()->listeners().Append(
+          new at::test::PerfListener(json_path));
+    }
+  }
+
   int ret = RUN_ALL_TESTS();
 
   return ret;
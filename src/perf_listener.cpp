@@ -0,0 +1,135 @@
+#include "perf_listener.h"
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "proc_status.h"
+
+namespace at {
+namespace test {
+namespace {
+
+#if USE_PADDLE_API
+constexpr const char* kBackendName = "paddle";
+#else
+constexpr const char* kBackendName = "torch";
+#endif
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+}  // namespace
+
+PerfListener::PerfListener(std::string json_path)
+    : json_path_(std::move(json_path)) {}
+
+PerfListener::Snapshot PerfListener::TakeSnapshot() {
+  Snapshot snapshot;
+  snapshot.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+  timespec cpu;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu) == 0) {
+    snapshot.cpu_ns = int64_t{cpu.tv_sec} * 1000000000 + cpu.tv_nsec;
+  }
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    snapshot.max_rss_kb = usage.ru_maxrss;
+    snapshot.minor_faults = usage.ru_minflt;
+    snapshot.major_faults = usage.ru_majflt;
+  }
+  snapshot.rss_kb = ReadStatusKb("VmRSS");
+  return snapshot;
+}
+
+void PerfListener::OnTestStart(const ::testing::TestInfo& test_info) {
+  peak_reset_ = ResetPeakRss();
+  alloc_scope_ = std::make_unique<AllocScope>();
+  start_ = TakeSnapshot();
+}
+
+void PerfListener::OnTestEnd(const ::testing::TestInfo& test_info) {
+  Snapshot end = TakeSnapshot();
+  AllocStats alloc_stats = alloc_scope_->Stats();
+  alloc_scope_.reset();
+  Record record;
+  record.name =
+      std::string(test_info.test_suite_name()) + "." + test_info.name();
+  record.passed = test_info.result() == nullptr || test_info.result()->Passed();
+  record.wall_ms = (end.wall_ns - start_.wall_ns) / 1e6;
+  record.cpu_ms = (end.cpu_ns - start_.cpu_ns) / 1e6;
+  int64_t hwm_kb = peak_reset_ ? ReadStatusKb("VmHWM") : -1;
+  if (hwm_kb >= 0 && start_.rss_kb >= 0) {
+    record.peak_rss_delta_kb = std::max<int64_t>(0, hwm_kb - start_.rss_kb);
+  } else {
+    // Without a resettable peak only growth of the process-wide peak shows.
+    record.peak_rss_delta_kb = end.max_rss_kb - start_.max_rss_kb;
+  }
+  record.minor_faults = end.minor_faults - start_.minor_faults;
+  record.major_faults = end.major_faults - start_.major_faults;
+  record.allocs = alloc_stats.allocs;
+  record.alloc_bytes = alloc_stats.bytes;
+  records_.push_back(std::move(record));
+}
+
+void PerfListener::OnTestProgramEnd(const ::testing::UnitTest& unit_test) {
+  std::ofstream out(json_path_);
+  if (!out) {
+    std::cerr << "PerfListener: cannot open " << json_path_ << std::endl;
+    return;
+  }
+  out << "{\n  \"backend\": \"" << kBackendName << "\",\n  \"tests\": [";
+  for (size_t i = 0; i < records_.size(); ++i) {
+    const Record& r = records_[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << JsonEscape(r.name)
+        << "\", \"passed\": " << (r.passed ? "true" : "false")
+        << ", \"wall_ms\": " << r.wall_ms << ", \"cpu_ms\": " << r.cpu_ms
+        << ", \"peak_rss_delta_kb\": " << r.peak_rss_delta_kb
+        << ", \"minor_faults\": " << r.minor_faults
+        << ", \"major_faults\": " << r.major_faults
+        << ", \"allocs\": " << r.allocs
+        << ", \"alloc_bytes\": " << r.alloc_bytes << "}";
+  }
+  out << "\n  ]\n}\n";
+
+  std::vector<const Record*> slowest;
+  for (const Record& record : records_) {
+    slowest.push_back(&record);
+  }
+  std::sort(slowest.begin(),
+            slowest.end(),
+            [](const Record* a, const Record* b) {
+              return a->wall_ms > b->wall_ms;
+            });
+  slowest.resize(std::min<size_t>(slowest.size(), 5));
+  std::cout << "[ PERF     ] " << records_.size() << " tests written to "
+            << json_path_ << ", slowest:" << std::endl;
+  for (const Record* record : slowest) {
+    char line[256];
+    std::snprintf(line,
+                  sizeof(line),
+                  "[ PERF     ] %-48s %10.3f ms wall %10.3f ms cpu",
+                  record->name.c_str(),
+                  record->wall_ms,
+                  record->cpu_ms);
+    std::cout << line << std::endl;
+  }
+}
+
+}  // namespace test
+}  // namespace at
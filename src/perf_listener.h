@@ -0,0 +1,61 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+namespace at {
+namespace test {
+
+// Records wall time, CPU time, peak RSS growth, page faults and heap
+// allocations of every test and writes them to a JSON file when the test
+// program ends. This gives a per-API cost on each backend instead of only
+// the CTest timeout.
+class PerfListener : public ::testing::EmptyTestEventListener {
+ public:
+  explicit PerfListener(std::string json_path);
+
+  void OnTestStart(const ::testing::TestInfo& test_info) override;
+  void OnTestEnd(const ::testing::TestInfo& test_info) override;
+  void OnTestProgramEnd(const ::testing::UnitTest& unit_test) override;
+
+ private:
+  struct Snapshot {
+    int64_t wall_ns = 0;
+    int64_t cpu_ns = 0;
+    int64_t rss_kb = 0;
+    int64_t max_rss_kb = 0;
+    int64_t minor_faults = 0;
+    int64_t major_faults = 0;
+  };
+
+  struct Record {
+    std::string name;
+    bool passed = true;
+    double wall_ms = 0;
+    double cpu_ms = 0;
+    int64_t peak_rss_delta_kb = 0;
+    int64_t minor_faults = 0;
+    int64_t major_faults = 0;
+    int64_t allocs = 0;
+    int64_t alloc_bytes = 0;
+  };
+
+  static Snapshot TakeSnapshot();
+
+  std::string json_path_;
+  Snapshot start_;
+  // Whether the kernel peak RSS counter was reset at the start of the
+  // current test, in which case VmHWM is the peak of this test alone.
+  bool peak_reset_ = false;
+  std::unique_ptr<AllocScope> alloc_scope_;
+  std::vector<Record> records_;
+};
+
+}  // namespace test
+}  // namespace at
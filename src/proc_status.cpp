@@ -0,0 +1,33 @@
+#include "proc_status.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace at {
+namespace test {
+
+int64_t ReadStatusKb(const char* key) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  std::string prefix = std::string(key) + ":";
+  while (std::getline(status, line)) {
+    if (line.compare(0, prefix.size(), prefix) == 0) {
+      return std::atoll(line.c_str() + prefix.size());
+    }
+  }
+  return -1;
+}
+
+bool ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (!clear_refs) {
+    return false;
+  }
+  clear_refs << "5";
+  clear_refs.flush();
+  return static_cast<bool>(clear_refs);
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+namespace test {
+
+// Reads a "<key>:   <value> kB" line of /proc/self/status (e.g. "VmRSS",
+// "VmHWM"), -1 if missing.
+int64_t ReadStatusKb(const char* key);
+
+// Resets VmHWM to the current RSS by writing "5" to /proc/self/clear_refs
+// (Linux >= 4.0). Returns false when the kernel does not allow it, in which
+// case VmHWM stays the peak of the whole process.
+bool ResetPeakRss();
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,123 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/zeros.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace at {
+namespace test {
+
+// Creates and destroys tensors from many threads at once, as request
+// threads of a server do. Failures are counted on the workers and checked
+// on the main thread. Build with -DENABLE_TSAN=ON to also catch data races
+// in the compat layer's allocator and refcounting.
+class ConcurrencyTest : public ::testing::Test {
+ protected:
+  static constexpr int kThreads = 8;
+  static constexpr int kIterations = 2000;
+
+  // Runs body(thread_index, iteration) on kThreads threads that start
+  // together.
+  void RunConcurrently(const std::function<void(int, int)>& body) {
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        ready.fetch_add(1);
+        while (ready.load() < kThreads) {
+          std::this_thread::yield();
+        }
+        for (int i = 0; i < kIterations; ++i) {
+          body(t, i);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::atomic<int> failures{0};
+};
+
+// 测试多线程并发创建和销毁 zeros/ones/empty
+TEST_F(ConcurrencyTest, FactoryCreateDestroy) {
+  RunConcurrently([this](int, int i) {
+    at::Tensor zeros = at::zeros({4, 8}, at::kFloat);
+    at::Tensor ones = at::ones({4, 8}, at::kFloat);
+    at::Tensor empty = at::empty({i % 16 + 1}, at::kFloat);
+    if (zeros.data_ptr<float>()[31] != 0.0f ||
+        ones.data_ptr<float>()[31] != 1.0f || empty.numel() != i % 16 + 1) {
+      failures.fetch_add(1);
+    }
+  });
+  EXPECT_EQ(failures.load(), 0);
+}
+
+// 测试多线程并发 reshape 和 cat
+TEST_F(ConcurrencyTest, ReshapeAndCat) {
+  RunConcurrently([this](int t, int) {
+    at::Tensor tensor = at::ones({2, 3}, at::kFloat);
+    tensor.data_ptr<float>()[0] = static_cast<float>(t);
+    at::Tensor reshaped = tensor.reshape({6});
+    at::Tensor cat = at::cat({tensor, tensor}, 0);
+    if (reshaped.data_ptr() != tensor.data_ptr() || cat.sizes()[0] != 4 ||
+        cat.data_ptr<float>()[6] != static_cast<float>(t)) {
+      failures.fetch_add(1);
+    }
+  });
+  EXPECT_EQ(failures.load(), 0);
+}
+
+// 测试多个线程同时复制和释放同一个 tensor 的句柄（引用计数）
+TEST_F(ConcurrencyTest, SharedTensorRefcount) {
+  at::Tensor shared = at::ones({16}, at::kFloat);
+  RunConcurrently([this, &shared](int, int) {
+    at::Tensor copy = shared;
+    at::Tensor view = copy.reshape({4, 4});
+    if (view.data_ptr() != shared.data_ptr() ||
+        view.data_ptr<float>()[15] != 1.0f) {
+      failures.fetch_add(1);
+    }
+  });
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(shared.numel(), 16);
+  EXPECT_FLOAT_EQ(shared.data_ptr<float>()[0], 1.0f);
+}
+
+// 测试在一个线程创建、在另一个线程销毁 tensor
+TEST_F(ConcurrencyTest, CrossThreadDestruction) {
+  std::mutex mutex;
+  std::deque<at::Tensor> handoff;
+  RunConcurrently([&](int t, int i) {
+    at::Tensor created = at::full({8}, static_cast<float>(t), at::kFloat);
+    at::Tensor taken;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      handoff.push_back(created);
+      if (i % 2 == 1) {
+        taken = handoff.front();
+        handoff.pop_front();
+      }
+    }
+    if (taken.defined() && taken.numel() != 8) {
+      failures.fetch_add(1);
+    }
+  });
+  EXPECT_EQ(failures.load(), 0);
+  handoff.clear();
+}
+
+}  // namespace test
+}  // namespace at
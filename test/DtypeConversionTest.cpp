@@ -0,0 +1,235 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/from_blob.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace at {
+namespace test {
+
+// Conversions between every pair of CPU scalar types, and the values at the
+// edges (narrowing, overflow, NaN, rounding) where a compat implementation
+// is most likely to differ from torch.
+class DtypeConversionTest : public ::testing::Test {
+ protected:
+  static const std::vector<at::ScalarType>& AllTypes() {
+    static const std::vector<at::ScalarType> types = {at::kBool,
+                                                      at::kByte,
+                                                      at::kChar,
+                                                      at::kShort,
+                                                      at::kInt,
+                                                      at::kLong,
+                                                      at::kHalf,
+                                                      at::kBFloat16,
+                                                      at::kFloat,
+                                                      at::kDouble};
+    return types;
+  }
+
+  // A tensor of the given dtype holding values, built from float64 or, for
+  // exact large integers, from int64.
+  static at::Tensor FromDoubles(std::vector<double> values,
+                                at::ScalarType dtype) {
+    at::Tensor source = at::from_blob(values.data(),
+                                      {static_cast<int64_t>(values.size())},
+                                      at::kDouble);
+    return source.toType(dtype).clone();
+  }
+
+  static at::Tensor FromLongs(std::vector<int64_t> values,
+                              at::ScalarType dtype) {
+    at::Tensor source = at::from_blob(
+        values.data(), {static_cast<int64_t>(values.size())}, at::kLong);
+    return source.toType(dtype).clone();
+  }
+
+  // Reads the tensor back as float64, which is exact for every source type
+  // except int64 values above 2^53.
+  static std::vector<double> ToDoubles(const at::Tensor& tensor) {
+    at::Tensor values = tensor.toType(at::kDouble).contiguous();
+    const double* data = values.data_ptr<double>();
+    return std::vector<double>(data, data + values.numel());
+  }
+
+  static const char* TypeName(at::ScalarType dtype) {
+    switch (dtype) {
+      case at::kBool:
+        return "bool";
+      case at::kByte:
+        return "uint8";
+      case at::kChar:
+        return "int8";
+      case at::kShort:
+        return "int16";
+      case at::kInt:
+        return "int32";
+      case at::kLong:
+        return "int64";
+      case at::kHalf:
+        return "float16";
+      case at::kBFloat16:
+        return "bfloat16";
+      case at::kFloat:
+        return "float32";
+      case at::kDouble:
+        return "float64";
+      default:
+        return "unknown";
+    }
+  }
+
+  static std::string PairName(at::ScalarType from, at::ScalarType to) {
+    return std::string(TypeName(from)) + " -> " + TypeName(to);
+  }
+};
+
+// 测试所有 dtype 两两之间转换小整数
+TEST_F(DtypeConversionTest, AllPairsSmallIntegers) {
+  for (at::ScalarType from : AllTypes()) {
+    std::vector<double> values = {0, 1, 2, 7, 100};
+    if (from == at::kBool) {
+      values = {0, 1, 0, 1, 1};
+    }
+    at::Tensor source = FromDoubles(values, from);
+    for (at::ScalarType to : AllTypes()) {
+      at::Tensor result = source.toType(to);
+      ASSERT_EQ(result.scalar_type(), to) << PairName(from, to);
+      ASSERT_EQ(result.numel(), 5) << PairName(from, to);
+      std::vector<double> actual = ToDoubles(result);
+      for (size_t i = 0; i < values.size(); ++i) {
+        double expected = to == at::kBool ? (values[i] != 0) : values[i];
+        EXPECT_EQ(actual[i], expected) << PairName(from, to) << " at " << i;
+      }
+    }
+  }
+}
+
+// 测试 to(dtype) 与 toType 结果一致
+TEST_F(DtypeConversionTest, ToMatchesToType) {
+  at::Tensor source = FromDoubles({-1.5, 0.25, 3.0}, at::kFloat);
+  for (at::ScalarType to : AllTypes()) {
+    at::Tensor by_to = source.to(to);
+    EXPECT_EQ(by_to.scalar_type(), to);
+    EXPECT_EQ(ToDoubles(by_to), ToDoubles(source.toType(to)))
+        << PairName(at::kFloat, to);
+  }
+}
+
+// 测试浮点转整数向零截断
+TEST_F(DtypeConversionTest, FloatToIntTruncatesTowardZero) {
+  at::Tensor source = FromDoubles({2.7, -2.7, 0.5, -0.5, 126.99}, at::kFloat);
+  for (at::ScalarType to : {at::kChar, at::kShort, at::kInt, at::kLong}) {
+    std::vector<double> expected = {2, -2, 0, 0, 126};
+    EXPECT_EQ(ToDoubles(source.toType(to)), expected)
+        << PairName(at::kFloat, to);
+  }
+}
+
+// 测试整数收窄按补码回绕
+TEST_F(DtypeConversionTest, IntegerNarrowingWraps) {
+  at::Tensor source = FromLongs({300, -129, 255, 256, -1}, at::kLong);
+  EXPECT_EQ(ToDoubles(source.toType(at::kByte)),
+            (std::vector<double>{44, 127, 255, 0, 255}));
+  EXPECT_EQ(ToDoubles(source.toType(at::kChar)),
+            (std::vector<double>{44, 127, -1, 0, -1}));
+
+  at::Tensor wide = FromLongs({int64_t{1} << 32, (int64_t{1} << 31) + 5},
+                              at::kLong);
+  EXPECT_EQ(ToDoubles(wide.toType(at::kInt)),
+            (std::vector<double>{0, -2147483643.0}));
+}
+
+// 测试 int64 极值转换到 float64 和 int64 自身不丢失
+TEST_F(DtypeConversionTest, Int64Extremes) {
+  int64_t max = std::numeric_limits<int64_t>::max();
+  int64_t min = std::numeric_limits<int64_t>::min();
+  at::Tensor source = FromLongs({max, min}, at::kLong);
+  at::Tensor same = source.toType(at::kLong);
+  EXPECT_EQ(same.data_ptr<int64_t>()[0], max);
+  EXPECT_EQ(same.data_ptr<int64_t>()[1], min);
+  std::vector<double> as_double = ToDoubles(source);
+  EXPECT_EQ(as_double[0], static_cast<double>(max));
+  EXPECT_EQ(as_double[1], static_cast<double>(min));
+}
+
+// 测试超出 float16 范围的值变为 inf
+TEST_F(DtypeConversionTest, HalfOverflowToInfinity) {
+  at::Tensor source =
+      FromDoubles({70000.0, -70000.0, 65504.0, 1e-8}, at::kFloat);
+  std::vector<double> result = ToDoubles(source.toType(at::kHalf));
+  EXPECT_TRUE(std::isinf(result[0]) && result[0] > 0);
+  EXPECT_TRUE(std::isinf(result[1]) && result[1] < 0);
+  EXPECT_EQ(result[2], 65504.0);
+  EXPECT_EQ(result[3], 0.0);
+
+  // bfloat16 has the exponent range of float32
+  std::vector<double> bf16 = ToDoubles(source.toType(at::kBFloat16));
+  EXPECT_FALSE(std::isinf(bf16[0]));
+  EXPECT_NEAR(bf16[0], 70000.0, 70000.0 / 128);
+
+  at::Tensor huge = FromDoubles({1e300, -1e300}, at::kDouble);
+  std::vector<double> as_float = ToDoubles(huge.toType(at::kFloat));
+  EXPECT_TRUE(std::isinf(as_float[0]) && as_float[0] > 0);
+  EXPECT_TRUE(std::isinf(as_float[1]) && as_float[1] < 0);
+}
+
+// 测试 NaN 在浮点类型之间保留，转 bool 为 true
+TEST_F(DtypeConversionTest, NaNPropagates) {
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  at::Tensor source = FromDoubles({nan, 1.0}, at::kFloat);
+  for (at::ScalarType to : {at::kHalf, at::kBFloat16, at::kDouble}) {
+    std::vector<double> result = ToDoubles(source.toType(to));
+    EXPECT_TRUE(std::isnan(result[0])) << PairName(at::kFloat, to);
+    EXPECT_EQ(result[1], 1.0) << PairName(at::kFloat, to);
+  }
+  EXPECT_EQ(ToDoubles(source.toType(at::kBool)),
+            (std::vector<double>{1, 1}));
+}
+
+// 测试浮点转 bool: 只有 0 和 -0 为 false
+TEST_F(DtypeConversionTest, FloatToBool) {
+  at::Tensor source = FromDoubles({0.0, -0.0, 0.1, -3.0, 1e-30}, at::kFloat);
+  EXPECT_EQ(ToDoubles(source.toType(at::kBool)),
+            (std::vector<double>{0, 0, 1, 1, 1}));
+}
+
+// 测试转 float16/bfloat16 时舍入到最近偶数
+TEST_F(DtypeConversionTest, HalfPrecisionRoundsToNearestEven) {
+  // float16 has 10 mantissa bits: ulp(1) = 2^-10.
+  double half_ulp = std::ldexp(1.0, -10);
+  at::Tensor half_source = FromDoubles(
+      {1 + half_ulp / 2, 1 + 3 * half_ulp / 2, 1 + half_ulp / 4}, at::kFloat);
+  EXPECT_EQ(ToDoubles(half_source.toType(at::kHalf)),
+            (std::vector<double>{1.0, 1 + 2 * half_ulp, 1.0}));
+
+  // bfloat16 has 7 mantissa bits: ulp(1) = 2^-7.
+  double bf16_ulp = std::ldexp(1.0, -7);
+  at::Tensor bf16_source = FromDoubles(
+      {1 + bf16_ulp / 2, 1 + 3 * bf16_ulp / 2, 1 + 3 * bf16_ulp / 4},
+      at::kFloat);
+  EXPECT_EQ(ToDoubles(bf16_source.toType(at::kBFloat16)),
+            (std::vector<double>{1.0, 1 + 2 * bf16_ulp, 1 + bf16_ulp}));
+
+  // float64 -> float32 rounds to nearest as well.
+  at::Tensor tenth = FromDoubles({0.1}, at::kDouble);
+  at::Tensor as_float = tenth.toType(at::kFloat);
+  EXPECT_EQ(as_float.data_ptr<float>()[0], 0.1f);
+}
+
+// 测试非连续输入的转换
+TEST_F(DtypeConversionTest, NonContiguousInput) {
+  at::Tensor source =
+      FromDoubles({0, 1, 2, 3, 4, 5}, at::kInt).reshape({2, 3}).transpose(0, 1);
+  at::Tensor result = source.toType(at::kDouble);
+  EXPECT_EQ(result.sizes()[0], 3);
+  EXPECT_EQ(result.sizes()[1], 2);
+  EXPECT_EQ(ToDoubles(result), (std::vector<double>{0, 3, 1, 4, 2, 5}));
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,138 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/ones.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+#include <c10/core/InferenceMode.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace at {
+namespace test {
+
+// Inference-only callers rely on NoGradGuard and InferenceMode to skip
+// autograd bookkeeping. These tests check that both guards are honored and
+// scoped, and that factory ops do not create tensors requiring grad.
+class GradModeTest : public ::testing::Test {
+ protected:
+  void SetUp() override { tensor = at::full({2, 3}, -2.0f, at::kFloat); }
+
+  at::Tensor tensor;
+};
+
+// 测试工厂函数默认不需要梯度
+TEST_F(GradModeTest, FactoryOpsDoNotRequireGrad) {
+  std::vector<at::Tensor> tensors = {at::zeros({2, 3}, at::kFloat),
+                                     at::ones({2, 3}, at::kFloat),
+                                     at::full({2, 3}, 1.5f, at::kFloat),
+                                     at::empty({2, 3}, at::kFloat),
+                                     at::arange(6, at::kFloat)};
+  for (const at::Tensor& t : tensors) {
+    EXPECT_FALSE(t.requires_grad());
+  }
+}
+
+TEST_F(GradModeTest, RequiresGradOption) {
+  at::TensorOptions options =
+      at::TensorOptions().dtype(at::kFloat).requires_grad(true);
+  at::Tensor result = at::zeros({2, 3}, options);
+  EXPECT_TRUE(result.requires_grad());
+}
+
+TEST_F(GradModeTest, SetRequiresGrad) {
+  tensor.set_requires_grad(true);
+  EXPECT_TRUE(tensor.requires_grad());
+  tensor.set_requires_grad(false);
+  EXPECT_FALSE(tensor.requires_grad());
+}
+
+// 需要梯度的输入经过算子后结果也需要梯度
+TEST_F(GradModeTest, OpResultRequiresGrad) {
+  tensor.set_requires_grad(true);
+  at::Tensor result = at::abs(tensor);
+  EXPECT_TRUE(result.requires_grad());
+}
+
+TEST_F(GradModeTest, NoGradGuardDisablesGradMode) {
+  EXPECT_TRUE(at::GradMode::is_enabled());
+  {
+    at::NoGradGuard guard;
+    EXPECT_FALSE(at::GradMode::is_enabled());
+  }
+  EXPECT_TRUE(at::GradMode::is_enabled());
+}
+
+// 测试 NoGradGuard 下算子结果不记录梯度
+TEST_F(GradModeTest, NoGradGuardResultDoesNotRequireGrad) {
+  tensor.set_requires_grad(true);
+  at::NoGradGuard guard;
+  at::Tensor result = at::abs(tensor);
+  at::Tensor total = at::sum(result);
+  EXPECT_FALSE(result.requires_grad());
+  EXPECT_FALSE(total.requires_grad());
+  EXPECT_FLOAT_EQ(*total.data_ptr<float>(), 12.0f);
+}
+
+TEST_F(GradModeTest, NestedNoGradGuard) {
+  {
+    at::NoGradGuard outer;
+    {
+      at::NoGradGuard inner;
+      EXPECT_FALSE(at::GradMode::is_enabled());
+    }
+    EXPECT_FALSE(at::GradMode::is_enabled());
+  }
+  EXPECT_TRUE(at::GradMode::is_enabled());
+}
+
+TEST_F(GradModeTest, InferenceModeIsScoped) {
+  EXPECT_FALSE(c10::InferenceMode::is_enabled());
+  {
+    c10::InferenceMode guard;
+    EXPECT_TRUE(c10::InferenceMode::is_enabled());
+    EXPECT_FALSE(at::GradMode::is_enabled());
+  }
+  EXPECT_FALSE(c10::InferenceMode::is_enabled());
+  EXPECT_TRUE(at::GradMode::is_enabled());
+}
+
+TEST_F(GradModeTest, InferenceModeDisabledGuard) {
+  c10::InferenceMode guard;
+  {
+    c10::InferenceMode disabled(false);
+    EXPECT_FALSE(c10::InferenceMode::is_enabled());
+  }
+  EXPECT_TRUE(c10::InferenceMode::is_enabled());
+}
+
+// 测试 InferenceMode 下创建的 tensor 是 inference tensor
+TEST_F(GradModeTest, InferenceModeCreatesInferenceTensors) {
+  EXPECT_FALSE(tensor.is_inference());
+  c10::InferenceMode guard;
+  at::Tensor created = at::zeros({2, 3}, at::kFloat);
+  at::Tensor result = at::abs(tensor);
+  at::Tensor view = result.reshape({6});
+
+  EXPECT_TRUE(created.is_inference());
+  EXPECT_TRUE(result.is_inference());
+  EXPECT_TRUE(view.is_inference());
+  EXPECT_FALSE(result.requires_grad());
+  EXPECT_FLOAT_EQ(result.data_ptr<float>()[0], 2.0f);
+}
+
+TEST_F(GradModeTest, InferenceModeIgnoresRequiresGradInput) {
+  tensor.set_requires_grad(true);
+  c10::InferenceMode guard;
+  at::Tensor result = at::sum(at::abs(tensor));
+  EXPECT_FALSE(result.requires_grad());
+  EXPECT_FLOAT_EQ(*result.data_ptr<float>(), 12.0f);
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,297 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <gtest/gtest.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace at {
+namespace test {
+
+// Intra-op threading API that custom CPU kernels are written against. The
+// thread count is restored after every test, since it is process wide.
+class ParallelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    at::init_num_threads();
+    saved_threads = at::get_num_threads();
+  }
+
+  void TearDown() override { at::set_num_threads(saved_threads); }
+
+  // Records the [begin, end) chunks handed to the body of parallel_for.
+  std::vector<std::pair<int64_t, int64_t>> Chunks(int64_t begin,
+                                                  int64_t end,
+                                                  int64_t grain_size) {
+    std::mutex mutex;
+    std::vector<std::pair<int64_t, int64_t>> chunks;
+    at::parallel_for(begin, end, grain_size, [&](int64_t b, int64_t e) {
+      std::lock_guard<std::mutex> lock(mutex);
+      chunks.emplace_back(b, e);
+    });
+    std::sort(chunks.begin(), chunks.end());
+    return chunks;
+  }
+
+  static bool MultiCore() { return std::thread::hardware_concurrency() > 1; }
+
+  int saved_threads = 1;
+};
+
+TEST_F(ParallelTest, SetAndGetNumThreads) {
+  at::set_num_threads(2);
+  EXPECT_EQ(at::get_num_threads(), 2);
+  at::set_num_threads(1);
+  EXPECT_EQ(at::get_num_threads(), 1);
+}
+
+TEST_F(ParallelTest, InitNumThreadsKeepsSetting) {
+  at::set_num_threads(2);
+  at::init_num_threads();
+  EXPECT_EQ(at::get_num_threads(), 2);
+}
+
+// 测试每个下标恰好被处理一次
+TEST_F(ParallelTest, ParallelForCoversRangeOnce) {
+  at::set_num_threads(4);
+  const int64_t n = 100003;
+  std::vector<std::atomic<int>> visits(n);
+  for (auto& visit : visits) {
+    visit.store(0);
+  }
+  at::parallel_for(0, n, 64, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      visits[i].fetch_add(1);
+    }
+  });
+  for (int64_t i = 0; i < n; ++i) {
+    ASSERT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+}
+
+TEST_F(ParallelTest, ParallelForNonZeroBegin) {
+  std::vector<std::pair<int64_t, int64_t>> chunks = Chunks(10, 1010, 1);
+  ASSERT_FALSE(chunks.empty());
+  EXPECT_EQ(chunks.front().first, 10);
+  EXPECT_EQ(chunks.back().second, 1010);
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    EXPECT_EQ(chunks[i].first, chunks[i - 1].second);
+  }
+}
+
+TEST_F(ParallelTest, ParallelForEmptyRange) {
+  bool called = false;
+  at::parallel_for(5, 5, 1, [&](int64_t, int64_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+// 范围不超过 grain_size 时应在调用线程上一次处理完
+TEST_F(ParallelTest, RangeWithinGrainSizeRunsInline) {
+  at::set_num_threads(4);
+  std::thread::id caller = std::this_thread::get_id();
+  std::vector<std::pair<int64_t, int64_t>> chunks;
+  std::thread::id body_thread;
+  at::parallel_for(0, 1000, 1000, [&](int64_t b, int64_t e) {
+    chunks.emplace_back(b, e);
+    body_thread = std::this_thread::get_id();
+  });
+  ASSERT_EQ(chunks.size(), 1u);
+  EXPECT_EQ(chunks[0], std::make_pair(int64_t{0}, int64_t{1000}));
+  EXPECT_EQ(body_thread, caller);
+}
+
+// 除最后一块外，每块至少 grain_size 个元素
+TEST_F(ParallelTest, ChunksRespectGrainSize) {
+  at::set_num_threads(8);
+  const int64_t grain = 1000;
+  std::vector<std::pair<int64_t, int64_t>> chunks = Chunks(0, 10500, grain);
+  for (const auto& chunk : chunks) {
+    if (chunk.second != 10500) {
+      EXPECT_GE(chunk.second - chunk.first, grain);
+    }
+  }
+}
+
+TEST_F(ParallelTest, SingleThreadRunsOneChunk) {
+  at::set_num_threads(1);
+  std::vector<std::pair<int64_t, int64_t>> chunks = Chunks(0, 100000, 1);
+  ASSERT_EQ(chunks.size(), 1u);
+  EXPECT_EQ(chunks[0].second, 100000);
+}
+
+// 多核机器上大范围的 parallel_for 必须真正用到多个线程
+TEST_F(ParallelTest, ParallelForUsesMultipleThreads) {
+  if (!MultiCore()) {
+    GTEST_SKIP() << "single core machine";
+  }
+  at::set_num_threads(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<int> arrived(0);
+  at::parallel_for(0, 2, 1, [&](int64_t, int64_t) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    }
+    // Both chunks wait for each other (bounded), so a pool that ran them
+    // one after another on the same thread is still detected.
+    arrived.fetch_add(1);
+    for (int spin = 0; spin < 100000 && arrived.load() < 2; ++spin) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(threads.size(), 2u);
+}
+
+// 连续调用应复用线程池，而不是每次调用都创建新线程
+TEST_F(ParallelTest, WorkerThreadsAreReused) {
+  if (!MultiCore()) {
+    GTEST_SKIP() << "single core machine";
+  }
+  at::set_num_threads(2);
+  std::mutex mutex;
+  std::set<int64_t> tids;
+  for (int call = 0; call < 50; ++call) {
+    at::parallel_for(0, 1024, 1, [&](int64_t, int64_t) {
+      std::lock_guard<std::mutex> lock(mutex);
+      tids.insert(static_cast<int64_t>(syscall(SYS_gettid)));
+    });
+  }
+  // The caller plus at most one worker per thread.
+  EXPECT_LE(tids.size(), static_cast<size_t>(at::get_num_threads()) + 1);
+}
+
+TEST_F(ParallelTest, ThreadNumAndParallelRegion) {
+  at::set_num_threads(4);
+  EXPECT_FALSE(at::in_parallel_region());
+  std::atomic<int> bad_thread_num(0);
+  std::atomic<int> chunks(0);
+  std::atomic<int> in_region(0);
+  at::parallel_for(0, 4096, 1, [&](int64_t, int64_t) {
+    int thread_num = at::get_thread_num();
+    if (thread_num < 0 || thread_num >= at::get_num_threads()) {
+      bad_thread_num.fetch_add(1);
+    }
+    chunks.fetch_add(1);
+    in_region.fetch_add(at::in_parallel_region() ? 1 : 0);
+  });
+  EXPECT_EQ(bad_thread_num.load(), 0);
+  if (chunks.load() > 1) {
+    EXPECT_EQ(in_region.load(), chunks.load());
+  }
+  EXPECT_FALSE(at::in_parallel_region());
+}
+
+// 嵌套的 parallel_for 在外层线程上串行执行，且结果完整
+TEST_F(ParallelTest, NestedParallelForRunsInline) {
+  at::set_num_threads(4);
+  const int64_t outer = 8;
+  const int64_t inner = 1000;
+  std::vector<std::atomic<int>> visits(outer * inner);
+  for (auto& visit : visits) {
+    visit.store(0);
+  }
+  std::atomic<int> foreign_inner(0);
+  at::parallel_for(0, outer, 1, [&](int64_t ob, int64_t oe) {
+    std::thread::id outer_thread = std::this_thread::get_id();
+    for (int64_t o = ob; o < oe; ++o) {
+      at::parallel_for(0, inner, 1, [&](int64_t ib, int64_t ie) {
+        if (std::this_thread::get_id() != outer_thread) {
+          foreign_inner.fetch_add(1);
+        }
+        for (int64_t i = ib; i < ie; ++i) {
+          visits[o * inner + i].fetch_add(1);
+        }
+      });
+    }
+  });
+  for (int64_t i = 0; i < outer * inner; ++i) {
+    ASSERT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+  EXPECT_EQ(foreign_inner.load(), 0);
+}
+
+TEST_F(ParallelTest, ParallelReduceSum) {
+  at::set_num_threads(4);
+  for (int64_t grain : {1, 100, 4096, 1 << 20}) {
+    const int64_t n = 1 << 16;
+    int64_t sum = at::parallel_reduce(
+        0,
+        n,
+        grain,
+        int64_t{0},
+        [](int64_t begin, int64_t end, int64_t ident) {
+          int64_t partial = ident;
+          for (int64_t i = begin; i < end; ++i) {
+            partial += i;
+          }
+          return partial;
+        },
+        [](int64_t a, int64_t b) { return a + b; });
+    EXPECT_EQ(sum, n * (n - 1) / 2) << "grain " << grain;
+  }
+}
+
+TEST_F(ParallelTest, ParallelReduceEmptyReturnsIdentity) {
+  float result = at::parallel_reduce(
+      3,
+      3,
+      1,
+      -1.5f,
+      [](int64_t, int64_t, float ident) { return ident + 1.0f; },
+      [](float a, float b) { return a + b; });
+  EXPECT_FLOAT_EQ(result, -1.5f);
+}
+
+TEST_F(ParallelTest, ParallelReduceMax) {
+  at::set_num_threads(4);
+  std::vector<int64_t> values(50000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int64_t>((i * 7919) % 50000);
+  }
+  int64_t result = at::parallel_reduce(
+      0,
+      static_cast<int64_t>(values.size()),
+      128,
+      int64_t{-1},
+      [&](int64_t begin, int64_t end, int64_t ident) {
+        int64_t best = ident;
+        for (int64_t i = begin; i < end; ++i) {
+          best = std::max(best, values[i]);
+        }
+        return best;
+      },
+      [](int64_t a, int64_t b) { return std::max(a, b); });
+  EXPECT_EQ(result, 49999);
+}
+
+// 工作线程中抛出的异常要传回调用线程
+TEST_F(ParallelTest, ExceptionPropagatesToCaller) {
+  at::set_num_threads(4);
+  EXPECT_THROW(at::parallel_for(0,
+                                4096,
+                                1,
+                                [](int64_t begin, int64_t end) {
+                                  if (begin <= 4000 && 4000 < end) {
+                                    throw std::runtime_error("chunk failed");
+                                  }
+                                }),
+               std::runtime_error);
+  // The pool stays usable afterwards.
+  std::atomic<int64_t> count(0);
+  at::parallel_for(0, 4096, 1, [&](int64_t begin, int64_t end) {
+    count.fetch_add(end - begin);
+  });
+  EXPECT_EQ(count.load(), 4096);
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,138 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/reshape.h>
+#include <ATen/ops/zeros.h>
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+namespace at {
+namespace test {
+
+// Operations that are metadata-only on torch must share storage with their
+// input on every backend. A hidden copy in the compat layer is reported as
+// the "copied_bytes" test property (visible in --gtest_output=xml) besides
+// failing the test.
+class ZeroCopyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tensor = at::zeros({4, 6}, at::kFloat);
+    float* data = tensor.data_ptr<float>();
+    for (int64_t i = 0; i < 24; ++i) {
+      data[i] = static_cast<float>(i);
+    }
+  }
+
+  // Runs op on tensor and checks that the result aliases the input. The
+  // bytes the call allocated and copied are recorded as test properties.
+  at::Tensor ExpectZeroCopy(const std::function<at::Tensor()>& op) {
+    at::Tensor result;
+    AllocStats stats;
+    {
+      AllocScope scope;
+      result = op();
+      stats = scope.Stats();
+    }
+    bool shared = result.data_ptr() == tensor.data_ptr();
+    int64_t copied_bytes =
+        shared ? 0
+               : result.numel() * static_cast<int64_t>(result.element_size());
+    RecordProperty("copied_bytes", std::to_string(copied_bytes));
+    RecordProperty("alloc_bytes", std::to_string(stats.bytes));
+    EXPECT_TRUE(shared) << "expected a view, but " << copied_bytes
+                        << " bytes were copied (" << stats.bytes
+                        << " bytes allocated)";
+    return result;
+  }
+
+  at::Tensor tensor;
+};
+
+// 测试 reshape 连续 tensor 不拷贝
+TEST_F(ZeroCopyTest, ReshapeContiguous) {
+  at::Tensor result =
+      ExpectZeroCopy([this]() { return tensor.reshape({24}); });
+  EXPECT_EQ(result.numel(), 24);
+
+  // 写入 view 后原 tensor 可见
+  result.data_ptr<float>()[5] = -1.0f;
+  EXPECT_FLOAT_EQ(tensor.data_ptr<float>()[5], -1.0f);
+}
+
+TEST_F(ZeroCopyTest, ReshapeFunctionContiguous) {
+  at::Tensor result =
+      ExpectZeroCopy([this]() { return at::reshape(tensor, {2, 3, 4}); });
+  EXPECT_EQ(result.dim(), 3);
+}
+
+// 测试已连续 tensor 的 contiguous() 不拷贝
+TEST_F(ZeroCopyTest, ContiguousOnContiguous) {
+  at::Tensor result = ExpectZeroCopy([this]() { return tensor.contiguous(); });
+  EXPECT_TRUE(result.is_contiguous());
+}
+
+// 测试 transpose 只修改 strides
+TEST_F(ZeroCopyTest, Transpose) {
+  at::Tensor result =
+      ExpectZeroCopy([this]() { return tensor.transpose(0, 1); });
+  EXPECT_EQ(result.sizes()[0], 6);
+  EXPECT_EQ(result.sizes()[1], 4);
+  EXPECT_EQ(result.strides()[0], 1);
+  EXPECT_EQ(result.strides()[1], 6);
+  EXPECT_FALSE(result.is_contiguous());
+}
+
+// 测试 toType 到相同 dtype 不拷贝
+TEST_F(ZeroCopyTest, ToTypeSameDtype) {
+  at::Tensor result =
+      ExpectZeroCopy([this]() { return tensor.toType(at::kFloat); });
+  EXPECT_EQ(result.dtype(), at::kFloat);
+}
+
+// 测试带显式 strides 的 from_blob 直接使用外部内存
+TEST_F(ZeroCopyTest, FromBlobWithStrides) {
+  // Large enough that a copy cannot hide among the metadata allocations.
+  std::vector<float> buffer(64 * 1024);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<float>(i);
+  }
+  // Column-major 64x1024 view of the buffer.
+  std::vector<int64_t> sizes = {64, 1024};
+  std::vector<int64_t> strides = {1, 64};
+
+  AllocScope scope;
+  at::Tensor result = at::from_blob(buffer.data(), sizes, strides);
+  AllocStats stats = scope.Stats();
+  bool shared = result.data_ptr<float>() == buffer.data();
+  int64_t copied_bytes =
+      shared ? 0
+             : result.numel() * static_cast<int64_t>(result.element_size());
+  RecordProperty("copied_bytes", std::to_string(copied_bytes));
+  RecordProperty("alloc_bytes", std::to_string(stats.bytes));
+
+  EXPECT_TRUE(shared);
+  EXPECT_EQ(result.strides()[0], 1);
+  EXPECT_EQ(result.strides()[1], 64);
+  EXPECT_LT(stats.bytes, static_cast<int64_t>(buffer.size() * sizeof(float)));
+
+  buffer[7] = -1.0f;
+  EXPECT_FLOAT_EQ(result.data_ptr<float>()[7], -1.0f);
+}
+
+// 对照组: 需要拷贝的操作应当分配新内存
+TEST_F(ZeroCopyTest, ContiguousOnTransposedCopies) {
+  at::Tensor transposed = tensor.transpose(0, 1);
+  at::Tensor result = transposed.contiguous();
+
+  EXPECT_TRUE(result.is_contiguous());
+  EXPECT_NE(result.data_ptr(), tensor.data_ptr());
+  EXPECT_FLOAT_EQ(result.data_ptr<float>()[1], 6.0f);
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,180 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/from_blob.h>
+#include <ATen/ops/sum.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+#include "proc_status.h"
+
+namespace at {
+namespace test {
+
+// Wraps a memory-mapped file with at::from_blob and a deleter that unmaps
+// it, the way model and feature loaders ingest large files. The tensor
+// and all of its views must use the mapping directly, and the deleter must
+// run exactly once, when the last of them dies.
+class FromBlobMmapTest : public ::testing::Test {
+ protected:
+  // 16 MiB, large enough that a hidden copy cannot hide among metadata
+  // allocations, small enough to stay fast.
+  static constexpr int64_t kRows = 2048;
+  static constexpr int64_t kCols = 2048;
+  static constexpr int64_t kBytes = kRows * kCols * sizeof(float);
+
+  void SetUp() override {
+    const char* tmpdir = std::getenv("TMPDIR");
+    path = std::string(tmpdir ? tmpdir : "/tmp") + "/from_blob_mmap_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    ASSERT_GE(fd, 0);
+    std::vector<float> values(kRows * kCols);
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<float>(i % 1000);
+    }
+    ASSERT_EQ(write(fd, values.data(), kBytes), kBytes);
+    // Private and writable, so writes through the tensor stay in memory.
+    mapping = mmap(nullptr, kBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    unmapped = 0;
+    unmap_result = -1;
+  }
+
+  void TearDown() override {
+    if (unmapped == 0 && mapping != MAP_FAILED) {
+      munmap(mapping, kBytes);
+    }
+    unlink(path.c_str());
+  }
+
+  // A {kRows, kCols} float tensor over the mapping that unmaps it when the
+  // storage is released.
+  at::Tensor WrapMapping() {
+    return at::from_blob(
+        mapping,
+        {kRows, kCols},
+        [this](void* data) {
+          ++unmapped;
+          unmap_result = munmap(data, kBytes);
+        },
+        at::TensorOptions().dtype(at::kFloat));
+  }
+
+  std::string path;
+  void* mapping = MAP_FAILED;
+  int unmapped = 0;
+  int unmap_result = -1;
+};
+
+TEST_F(FromBlobMmapTest, UsesMappingWithoutCopy) {
+  int64_t rss_before = ReadStatusKb("RssAnon");
+  AllocStats stats;
+  at::Tensor tensor;
+  {
+    AllocScope scope;
+    tensor = WrapMapping();
+    stats = scope.Stats();
+  }
+  RecordProperty("alloc_bytes", std::to_string(stats.bytes));
+
+  EXPECT_EQ(tensor.data_ptr(), mapping);
+  EXPECT_LT(stats.bytes, kBytes);
+  // A copy of the file would show up as anonymous memory.
+  int64_t rss_after = ReadStatusKb("RssAnon");
+  if (rss_before >= 0 && rss_after >= 0) {
+    EXPECT_LT(rss_after - rss_before, kBytes / 1024 / 2);
+  }
+  EXPECT_FLOAT_EQ(tensor.data_ptr<float>()[1234], 234.0f);
+}
+
+TEST_F(FromBlobMmapTest, ViewsShareMapping) {
+  at::Tensor tensor = WrapMapping();
+  AllocScope scope;
+  at::Tensor reshaped = tensor.reshape({kRows * kCols});
+  at::Tensor transposed = tensor.transpose(0, 1);
+  at::Tensor sliced = tensor.slice(0, 16, 32);
+  at::Tensor contiguous = tensor.contiguous();
+  AllocStats stats = scope.Stats();
+  RecordProperty("alloc_bytes", std::to_string(stats.bytes));
+
+  EXPECT_EQ(reshaped.data_ptr(), mapping);
+  EXPECT_EQ(transposed.data_ptr(), mapping);
+  EXPECT_EQ(contiguous.data_ptr(), mapping);
+  EXPECT_EQ(sliced.data_ptr<float>(),
+            static_cast<float*>(mapping) + 16 * kCols);
+  EXPECT_LT(stats.bytes, kBytes);
+  EXPECT_EQ(transposed.stride(0), 1);
+}
+
+TEST_F(FromBlobMmapTest, DeleterRunsOnceWhenLastTensorDies) {
+  {
+    at::Tensor tensor = WrapMapping();
+    at::Tensor copy = tensor;
+    EXPECT_EQ(unmapped, 0);
+  }
+  EXPECT_EQ(unmapped, 1);
+  EXPECT_EQ(unmap_result, 0);
+}
+
+// reshape/transpose 得到的 view 持有同一 storage，最后一个 view 释放时才 unmap
+TEST_F(FromBlobMmapTest, DeleterWaitsForViews) {
+  at::Tensor reshaped;
+  at::Tensor transposed;
+  {
+    at::Tensor tensor = WrapMapping();
+    reshaped = tensor.reshape({kRows * kCols});
+    transposed = tensor.transpose(0, 1);
+  }
+  EXPECT_EQ(unmapped, 0);
+  // The mapping is still readable through the views.
+  EXPECT_FLOAT_EQ(reshaped.data_ptr<float>()[999], 999.0f);
+
+  reshaped = at::Tensor();
+  EXPECT_EQ(unmapped, 0);
+  EXPECT_FLOAT_EQ(transposed.data_ptr<float>()[0], 0.0f);
+
+  transposed = at::Tensor();
+  EXPECT_EQ(unmapped, 1);
+  EXPECT_EQ(unmap_result, 0);
+}
+
+TEST_F(FromBlobMmapTest, DeleterRunsOnceAfterChainedViews) {
+  {
+    at::Tensor view = WrapMapping()
+                          .reshape({kRows / 2, 2, kCols})
+                          .transpose(0, 2)
+                          .slice(0, 0, 8);
+    EXPECT_EQ(unmapped, 0);
+    EXPECT_EQ(view.sizes()[0], 8);
+  }
+  EXPECT_EQ(unmapped, 1);
+}
+
+// 计算结果是新 tensor，不应持有映射
+TEST_F(FromBlobMmapTest, OpResultDoesNotKeepMapping) {
+  at::Tensor total;
+  {
+    at::Tensor tensor = WrapMapping();
+    total = at::sum(tensor.slice(0, 0, 1), at::kDouble);
+  }
+  EXPECT_EQ(unmapped, 1);
+  // Row 0 holds 0..999 twice and 0..47 once.
+  EXPECT_DOUBLE_EQ(*total.data_ptr<double>(),
+                   2 * 999.0 * 1000 / 2 + 47.0 * 48 / 2);
+}
+
+TEST_F(FromBlobMmapTest, WritesGoToMapping) {
+  at::Tensor tensor = WrapMapping();
+  tensor.data_ptr<float>()[5] = -1.0f;
+  EXPECT_FLOAT_EQ(static_cast<float*>(mapping)[5], -1.0f);
+}
+
+}  // namespace test
+}  // namespace at
@@ -0,0 +1,236 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Tensor.h>
+#include <ATen/ops/abs.h>
+#include <ATen/ops/arange.h>
+#include <ATen/ops/cat.h>
+#include <ATen/ops/empty.h>
+#include <ATen/ops/full.h>
+#include <ATen/ops/sum.h>
+#include <ATen/ops/zeros.h>
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+namespace at {
+namespace test {
+
+// _out and in-place variants must write into the given tensor. When the
+// output already has the right shape they must not allocate a new buffer
+// either, otherwise reusing outputs does not take any pressure off the
+// allocator.
+class OutVariantTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tensor = at::zeros({2, 3}, at::kFloat);
+    float* data = tensor.data_ptr<float>();
+    for (int64_t i = 0; i < 6; ++i) {
+      data[i] = static_cast<float>(i % 2 ? i : -i);  // 0, 1, -2, 3, -4, 5
+    }
+  }
+
+  // Runs op, which writes into out, and checks that out keeps its buffer
+  // and that the call allocates less than the output size. The allocated
+  // bytes are recorded as the "alloc_bytes" test property.
+  void ExpectNoOutputAllocation(at::Tensor out,
+                                const std::function<void()>& op) {
+    void* before = out.data_ptr();
+    AllocStats stats;
+    {
+      AllocScope scope;
+      op();
+      stats = scope.Stats();
+    }
+    RecordProperty("alloc_bytes", std::to_string(stats.bytes));
+    EXPECT_EQ(out.data_ptr(), before);
+    if (AllocTrackingAvailable()) {
+      int64_t out_bytes =
+          out.numel() * static_cast<int64_t>(out.element_size());
+      EXPECT_LT(stats.bytes, out_bytes)
+          << "the out variant allocated " << stats.bytes << " bytes ("
+          << stats.allocs << " allocations)";
+    }
+  }
+
+  at::Tensor tensor;
+};
+
+TEST_F(OutVariantTest, AbsOut) {
+  at::Tensor output = at::zeros({2, 3}, at::kFloat);
+  at::Tensor& result = at::abs_out(output, tensor);
+
+  EXPECT_EQ(&result, &output);
+  float* data = output.data_ptr<float>();
+  for (int64_t i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(data[i], static_cast<float>(i));
+  }
+  // 输入不变
+  EXPECT_FLOAT_EQ(tensor.data_ptr<float>()[2], -2.0f);
+}
+
+// 测试 out 为空 tensor 时被 resize 成结果形状
+TEST_F(OutVariantTest, AbsOutResizesEmptyOutput) {
+  at::Tensor output = at::empty({0}, at::kFloat);
+  at::abs_out(output, tensor);
+
+  EXPECT_EQ(output.dim(), 2);
+  EXPECT_EQ(output.sizes()[0], 2);
+  EXPECT_EQ(output.sizes()[1], 3);
+  EXPECT_FLOAT_EQ(output.data_ptr<float>()[4], 4.0f);
+}
+
+TEST_F(OutVariantTest, AbsInplace) {
+  void* before = tensor.data_ptr();
+  at::Tensor& result = tensor.abs_();
+
+  EXPECT_EQ(&result, &tensor);
+  EXPECT_EQ(tensor.data_ptr(), before);
+  float* data = tensor.data_ptr<float>();
+  for (int64_t i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(data[i], static_cast<float>(i));
+  }
+}
+
+TEST_F(OutVariantTest, AbsInplaceFunction) {
+  at::abs_(tensor);
+  EXPECT_FLOAT_EQ(tensor.data_ptr<float>()[2], 2.0f);
+  EXPECT_FLOAT_EQ(tensor.data_ptr<float>()[4], 4.0f);
+}
+
+TEST_F(OutVariantTest, CatOutDim0) {
+  std::vector<at::Tensor> tensors = {tensor, tensor};
+  at::Tensor output = at::zeros({4, 3}, at::kFloat);
+  at::Tensor& result = at::cat_out(output, tensors, 0);
+
+  EXPECT_EQ(&result, &output);
+  float* data = output.data_ptr<float>();
+  float* input = tensor.data_ptr<float>();
+  for (int64_t i = 0; i < 12; ++i) {
+    EXPECT_FLOAT_EQ(data[i], input[i % 6]);
+  }
+}
+
+TEST_F(OutVariantTest, CatOutDim1) {
+  std::vector<at::Tensor> tensors = {tensor, tensor};
+  at::Tensor output = at::zeros({2, 6}, at::kFloat);
+  at::cat_out(output, tensors, 1);
+
+  float* data = output.data_ptr<float>();
+  float* input = tensor.data_ptr<float>();
+  for (int64_t row = 0; row < 2; ++row) {
+    for (int64_t col = 0; col < 6; ++col) {
+      EXPECT_FLOAT_EQ(data[row * 6 + col], input[row * 3 + col % 3]);
+    }
+  }
+}
+
+TEST_F(OutVariantTest, SumOutDim) {
+  at::Tensor output = at::zeros({3}, at::kFloat);
+  at::Tensor& result = at::sum_out(output, tensor, {0}, false);
+
+  EXPECT_EQ(&result, &output);
+  float* data = output.data_ptr<float>();
+  EXPECT_FLOAT_EQ(data[0], 3.0f);   // 0+3
+  EXPECT_FLOAT_EQ(data[1], -3.0f);  // 1-4
+  EXPECT_FLOAT_EQ(data[2], 3.0f);   // -2+5
+}
+
+TEST_F(OutVariantTest, SumOutDimKeepdim) {
+  at::Tensor output = at::zeros({2, 1}, at::kFloat);
+  at::sum_out(output, tensor, {1}, true);
+
+  EXPECT_EQ(output.dim(), 2);
+  EXPECT_EQ(output.sizes()[1], 1);
+  EXPECT_FLOAT_EQ(output.data_ptr<float>()[0], -1.0f);  // 0+1-2
+  EXPECT_FLOAT_EQ(output.data_ptr<float>()[1], 4.0f);   // 3-4+5
+}
+
+TEST_F(OutVariantTest, ArangeOut) {
+  at::Tensor output = at::zeros({5}, at::kLong);
+  at::Tensor& result = at::arange_out(output, 5);
+
+  EXPECT_EQ(&result, &output);
+  int64_t* data = output.data_ptr<int64_t>();
+  for (int64_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(data[i], i);
+  }
+}
+
+TEST_F(OutVariantTest, ArangeOutStartEndStep) {
+  at::Tensor output = at::zeros({4}, at::kLong);
+  at::arange_out(output, 1, 9, 2);
+
+  int64_t* data = output.data_ptr<int64_t>();
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(data[i], 1 + 2 * i);
+  }
+}
+
+TEST_F(OutVariantTest, ZerosOut) {
+  at::Tensor output = at::full({2, 3}, 7.0f, at::kFloat);
+  at::Tensor& result = at::zeros_out(output, {2, 3});
+
+  EXPECT_EQ(&result, &output);
+  float* data = output.data_ptr<float>();
+  for (int64_t i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(data[i], 0.0f);
+  }
+}
+
+TEST_F(OutVariantTest, FullOut) {
+  at::Tensor output = at::zeros({3, 2}, at::kDouble);
+  at::Tensor& result = at::full_out(output, {3, 2}, 2.5);
+
+  EXPECT_EQ(&result, &output);
+  EXPECT_EQ(output.dtype(), at::kDouble);
+  double* data = output.data_ptr<double>();
+  for (int64_t i = 0; i < 6; ++i) {
+    EXPECT_DOUBLE_EQ(data[i], 2.5);
+  }
+}
+
+// 以下用例检查输出形状已正确时 out/in-place 变体不再分配输出内存。
+// 64K 元素足够大，输出分配不会被元数据分配掩盖。
+TEST_F(OutVariantTest, AbsOutDoesNotAllocate) {
+  at::Tensor input = at::full({256, 256}, -1.0f, at::kFloat);
+  at::Tensor output = at::empty({256, 256}, at::kFloat);
+  at::abs_out(output, input);  // warmup
+  ExpectNoOutputAllocation(output, [&]() { at::abs_out(output, input); });
+}
+
+TEST_F(OutVariantTest, AbsInplaceDoesNotAllocate) {
+  at::Tensor input = at::full({256, 256}, -1.0f, at::kFloat);
+  input.abs_();
+  ExpectNoOutputAllocation(input, [&]() { input.abs_(); });
+}
+
+TEST_F(OutVariantTest, CatOutDoesNotAllocate) {
+  at::Tensor input = at::full({128, 256}, 1.0f, at::kFloat);
+  std::vector<at::Tensor> tensors = {input, input};
+  at::Tensor output = at::empty({256, 256}, at::kFloat);
+  at::cat_out(output, tensors, 0);
+  ExpectNoOutputAllocation(output, [&]() { at::cat_out(output, tensors, 0); });
+}
+
+TEST_F(OutVariantTest, SumOutDimDoesNotAllocate) {
+  at::Tensor input = at::full({64, 65536}, 1.0f, at::kFloat);
+  at::Tensor output = at::empty({65536}, at::kFloat);
+  at::sum_out(output, input, {0}, false);
+  ExpectNoOutputAllocation(output,
+                           [&]() { at::sum_out(output, input, {0}, false); });
+}
+
+TEST_F(OutVariantTest, CreationOutDoesNotAllocate) {
+  at::Tensor output = at::empty({65536}, at::kFloat);
+  at::zeros_out(output, {65536});
+  ExpectNoOutputAllocation(output, [&]() { at::zeros_out(output, {65536}); });
+  ExpectNoOutputAllocation(output,
+                           [&]() { at::full_out(output, {65536}, 1.0f); });
+  ExpectNoOutputAllocation(output, [&]() { at::arange_out(output, 65536); });
+}
+
+}  // namespace test
+}  // namespace at
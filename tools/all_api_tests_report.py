@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+all_api_tests_report.py - 对比单文件测试二进制与合并后的 all_api_tests
+
+用法: python tools/all_api_tests_report.py <build_dir> [paddle|torch ...]
+
+对每个后端分别运行 <backend>/<backend>_*Test 与 <backend>/<backend>_all_api_tests，
+统计总墙钟时间，以及 glibc 动态链接器 (LD_DEBUG=statistics) 报告的
+加载 + 重定位耗时，输出合并后节省的比例。
+"""
+
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+ALL_TARGET = "all_api_tests"
+
+STARTUP_RE = re.compile(r"total startup time in dynamic loader:\s*(\d+)")
+RELOC_RE = re.compile(r"time needed for relocation:\s*(\d+)")
+
+
+def parse_loader_stats(stats_dir):
+    """汇总 LD_DEBUG_OUTPUT 写出的所有文件（每个进程一个）中的统计值，单位为 cycles"""
+    startup = 0
+    reloc = 0
+    for path in glob.glob(os.path.join(stats_dir, "ld.*")):
+        with open(path, "r", encoding="utf-8", errors="ignore") as f:
+            text = f.read()
+        # 第一段统计是启动阶段的，dlopen 之后的段不含 startup 字段
+        match = STARTUP_RE.search(text)
+        if match:
+            startup += int(match.group(1))
+        match = RELOC_RE.search(text)
+        if match:
+            reloc += int(match.group(1))
+    return startup, reloc
+
+
+def run_binaries(binaries):
+    """依次运行给定的二进制，返回 (墙钟秒数, loader cycles, 重定位 cycles, 失败列表)"""
+    failed = []
+    with tempfile.TemporaryDirectory() as stats_dir:
+        env = dict(os.environ)
+        env["LD_DEBUG"] = "statistics"
+        env["LD_DEBUG_OUTPUT"] = os.path.join(stats_dir, "ld")
+        start = time.perf_counter()
+        for binary in binaries:
+            ret = subprocess.run(
+                [binary],
+                env=env,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+                check=False,
+            )
+            if ret.returncode != 0:
+                failed.append(os.path.basename(binary))
+        wall = time.perf_counter() - start
+        startup, reloc = parse_loader_stats(stats_dir)
+    return wall, startup, reloc, failed
+
+
+def find_per_file_binaries(target_dir, backend):
+    prefix = os.path.join(target_dir, f"{backend}_")
+    binaries = []
+    for path in sorted(glob.glob(prefix + "*")):
+        name = os.path.basename(path)[len(backend) + 1 :]
+        if name.startswith("bench_") or name == ALL_TARGET:
+            continue
+        if os.access(path, os.X_OK) and os.path.isfile(path):
+            binaries.append(path)
+    return binaries
+
+
+def saving(before, after):
+    if before <= 0:
+        return 0.0
+    return (before - after) / before * 100
+
+
+def report_backend(build_dir, backend):
+    target_dir = os.path.join(build_dir, backend)
+    per_file = find_per_file_binaries(target_dir, backend)
+    combined = os.path.join(target_dir, f"{backend}_{ALL_TARGET}")
+    if not per_file or not os.path.exists(combined):
+        print(f"[{backend}] binaries not found in {target_dir}, skipped")
+        return True
+
+    split_wall, split_startup, split_reloc, split_failed = run_binaries(
+        per_file
+    )
+    all_wall, all_startup, all_reloc, all_failed = run_binaries([combined])
+
+    print(f"\n[{backend}] {len(per_file)} per-file binaries vs {ALL_TARGET}")
+    print(f"{'':<28} | {'per-file':>14} | {'combined':>14} | {'saved':>8}")
+    print("-" * 74)
+    rows = [
+        ("wall time (s)", split_wall, all_wall),
+        ("loader startup (Mcycles)", split_startup / 1e6, all_startup / 1e6),
+        ("relocation (Mcycles)", split_reloc / 1e6, all_reloc / 1e6),
+    ]
+    for label, before, after in rows:
+        print(
+            f"{label:<28} | {before:>14.3f} | {after:>14.3f} | "
+            f"{saving(before, after):>7.1f}%"
+        )
+    for name in split_failed + all_failed:
+        print(f"  FAILED: {name}")
+    return not split_failed and not all_failed
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(f"Usage: python {sys.argv[0]} <build_dir> [paddle|torch ...]")
+        sys.exit(1)
+
+    build_dir = sys.argv[1]
+    backends = sys.argv[2:] or ["paddle", "torch"]
+    ok = True
+    for backend in backends:
+        ok = report_backend(build_dir, backend) and ok
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
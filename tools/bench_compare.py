@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+bench_compare.py - 并排对比 torch 与 paddle 的 benchmark 结果
+
+用法:
+    # 运行 <build_dir>/{torch,paddle}/<backend>_bench_<name>，其余参数透传给二进制
+    python tools/bench_compare.py <build_dir> <name> [--filter=... ...]
+    # 直接对比两个已有的 --json 输出
+    python tools/bench_compare.py --json <torch.json> <paddle.json>
+"""
+
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def load_results(json_path):
+    """读取一个 benchmark JSON，返回 ({case 名: result}, 机器状态)"""
+    with open(json_path, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    results = {r["name"]: r for r in data["results"]}
+    return results, data.get("machine", {})
+
+
+def run_bench(build_dir, backend, name, extra_args, out_dir):
+    binary = os.path.join(build_dir, backend, f"{backend}_bench_{name}")
+    if not os.path.exists(binary):
+        print(f"Error: benchmark binary not found: {binary}")
+        sys.exit(1)
+    json_path = os.path.join(out_dir, f"{backend}.json")
+    subprocess.run(
+        [binary, f"--json={json_path}", *extra_args],
+        check=True,
+        stdout=subprocess.DEVNULL,
+    )
+    return load_results(json_path)
+
+
+def check_machines(torch_machine, paddle_machine):
+    """两次运行的机器状态不一致或存在噪声来源时给出提示"""
+    # 旧版本的 JSON 没有 machine 字段
+    keys = ("affinity", "governor", "smt", "turbo")
+    if not torch_machine or not paddle_machine:
+        keys = ()
+    for key in keys:
+        t_val = torch_machine.get(key)
+        p_val = paddle_machine.get(key)
+        if t_val != p_val:
+            print(f"Warning: {key} differs: torch={t_val} paddle={p_val}")
+    warnings = set(torch_machine.get("warnings", []))
+    warnings |= set(paddle_machine.get("warnings", []))
+    for warning in sorted(warnings):
+        print(f"Warning: {warning}")
+
+
+def median_ci(samples):
+    """中位数的 95% 置信区间，由次序统计量得到，不假设分布"""
+    values = sorted(samples)
+    n = len(values)
+    half = 1.96 * math.sqrt(n) / 2
+    lo = max(0, math.floor(n / 2 - half))
+    hi = min(n - 1, math.ceil(n / 2 + half) - 1)
+    return values[lo], values[hi]
+
+
+def within_noise(t, p):
+    """两个后端中位数的 95% 置信区间重叠，即 p/t 与 1 的差异不显著"""
+    if not t or not p or not t.get("samples_ns") or not p.get("samples_ns"):
+        return False
+    t_lo, t_hi = median_ci(t["samples_ns"])
+    p_lo, p_hi = median_ci(p["samples_ns"])
+    return t_lo <= p_hi and p_lo <= t_hi
+
+
+def ratio(paddle_value, torch_value):
+    if not torch_value:
+        return float("nan")
+    return paddle_value / torch_value
+
+
+def print_comparison(torch_results, paddle_results):
+    names = [n for n in torch_results if n in paddle_results]
+    names += [n for n in paddle_results if n not in torch_results]
+    counters = []
+    for result in list(torch_results.values()) + list(paddle_results.values()):
+        for key in result.get("counters", {}):
+            if key not in counters:
+                counters.append(key)
+
+    header = f"{'case':<48} | {'torch ns':>12} | {'paddle ns':>12} | {'p/t':>6}"
+    for key in counters:
+        header += f" | {key + ' t/p':>28}"
+    print(header)
+    print("-" * len(header))
+
+    for name in names:
+        t = torch_results.get(name)
+        p = paddle_results.get(name)
+        t_ns = t["median_ns"] if t else float("nan")
+        p_ns = p["median_ns"] if p else float("nan")
+        # "~" 表示两边中位数的置信区间重叠，差异不能归因于后端
+        noise = "~" if within_noise(t, p) else " "
+        line = (
+            f"{name:<48} | {t_ns:>12.1f} | {p_ns:>12.1f} | "
+            f"{ratio(p_ns, t_ns):>5.2f}{noise}"
+        )
+        for key in counters:
+            t_val = t.get("counters", {}).get(key) if t else None
+            p_val = p.get("counters", {}).get(key) if p else None
+            cell = f"{_fmt(t_val)} / {_fmt(p_val)}"
+            line += f" | {cell:>28}"
+        print(line)
+
+
+def _fmt(value):
+    if value is None:
+        return "-"
+    return f"{value:.4g}"
+
+
+def main():
+    if len(sys.argv) >= 4 and sys.argv[1] == "--json":
+        torch_results, torch_machine = load_results(sys.argv[2])
+        paddle_results, paddle_machine = load_results(sys.argv[3])
+    elif len(sys.argv) >= 3:
+        build_dir, name, extra_args = sys.argv[1], sys.argv[2], sys.argv[3:]
+        with tempfile.TemporaryDirectory() as out_dir:
+            torch_results, torch_machine = run_bench(
+                build_dir, "torch", name, extra_args, out_dir
+            )
+            paddle_results, paddle_machine = run_bench(
+                build_dir, "paddle", name, extra_args, out_dir
+            )
+    else:
+        print(__doc__)
+        sys.exit(1)
+
+    check_machines(torch_machine, paddle_machine)
+    print_comparison(torch_results, paddle_results)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+diff_runner.py - 通过 /dev/shm 对比 torch 与 paddle 的数值输出
+
+用法:
+    python tools/diff_runner.py <build_dir> [--numel N] [--reference torch]
+        [--filter SUBSTR] [--rtol R] [--atol A] [--json out.json]
+
+先运行参考后端的 <backend>_bench_DiffWorkload --shm_write，把每个结果写入
+/dev/shm/<prefix>.<workload>；再运行另一个后端的 --shm_compare，它只读映射这些
+共享内存并与自己的结果逐元素比较，打印不匹配个数、最大绝对/相对误差和最大 ULP。
+数据不经过磁盘文件或管道，GB 级输出也只在参考进程中拷贝一次。
+运行结束（包括失败）后删除本次创建的共享内存对象。有不匹配时退出码为 1。
+"""
+
+import argparse
+import glob
+import os
+import shutil
+import subprocess
+import sys
+
+BENCH_NAME = "DiffWorkload"
+SHM_DIR = "/dev/shm"
+BACKENDS = ("torch", "paddle")
+
+
+def binary_path(build_dir, backend):
+    path = os.path.join(build_dir, backend, f"{backend}_bench_{BENCH_NAME}")
+    if not os.path.exists(path):
+        print(f"Error: binary not found: {path}")
+        sys.exit(1)
+    return path
+
+
+def bytes_needed(binary, common):
+    """参考结果在 /dev/shm 中占用的总字节数，由二进制按所选 workload 给出"""
+    out = subprocess.run(
+        [binary, "--bytes_needed", *common],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    return int(out.strip())
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("build_dir")
+    parser.add_argument("--numel", type=int, default=1 << 24)
+    parser.add_argument("--reference", choices=BACKENDS, default="torch")
+    parser.add_argument("--filter", default="")
+    parser.add_argument("--rtol", type=float)
+    parser.add_argument("--atol", type=float)
+    parser.add_argument("--json", help="写入对比结果的 JSON 路径")
+    args = parser.parse_args()
+
+    candidate = BACKENDS[1] if args.reference == BACKENDS[0] else BACKENDS[0]
+    reference_bin = binary_path(args.build_dir, args.reference)
+    candidate_bin = binary_path(args.build_dir, candidate)
+
+    common = [f"--numel={args.numel}"]
+    if args.filter:
+        common.append(f"--filter={args.filter}")
+
+    free = shutil.disk_usage(SHM_DIR).free
+    needed = bytes_needed(reference_bin, common)
+    if needed > free:
+        print(
+            f"Warning: {SHM_DIR} has {free / 2**30:.1f} GiB free, the "
+            f"reference outputs need {needed / 2**30:.1f} GiB"
+        )
+    prefix = f"paddle_cpp_api_diff_{os.getpid()}"
+    try:
+        subprocess.run(
+            [reference_bin, f"--shm_write={prefix}", *common], check=True
+        )
+        compare = [candidate_bin, f"--shm_compare={prefix}", *common]
+        if args.rtol is not None:
+            compare.append(f"--rtol={args.rtol}")
+        if args.atol is not None:
+            compare.append(f"--atol={args.atol}")
+        if args.json:
+            compare.append(f"--json={args.json}")
+        print(f"reference: {args.reference}, candidate: {candidate}")
+        returncode = subprocess.run(compare).returncode
+    finally:
+        for path in glob.glob(os.path.join(SHM_DIR, prefix + ".*")):
+            os.remove(path)
+    sys.exit(returncode)
+
+
+if __name__ == "__main__":
+    main()
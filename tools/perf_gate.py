@@ -0,0 +1,386 @@
+#!/usr/bin/env python3
+"""
+perf_gate.py - 基于本地基线的性能回归门禁（仅依赖 Python 标准库，可离线运行）
+
+用法:
+    # 多次运行 benchmark，将结果保存为 <build_dir>/perf_baselines/<tag>/<backend>.json
+    python tools/perf_gate.py record <build_dir> [--tag TAG] [--runs N]
+        [--backend paddle] [--bench Abs --bench Sum ...] [-- bench 参数...]
+    # 重新运行并与基线对比（默认最新基线），有回归时退出码为 1
+    python tools/perf_gate.py compare <build_dir> [--baseline TAG]
+        [--candidate TAG] [--threshold 5] [--alpha 0.01] [--save TAG]
+    # 列出已保存的基线
+    python tools/perf_gate.py list <build_dir>
+
+对比方法: 同一进程内的各次重复共享校准、page cache 和频率状态，并不独立，
+因此每个用例以每轮运行的中位数为一个样本，用 Mann-Whitney U 检验（样本少时
+用精确分布）判断两组是否来自同一分布，并用 bootstrap 给出中位数比值 (新/旧)
+的置信区间。只有当比值超过 1 + threshold% 且 p < alpha 时才判定为回归；
+置信区间下界也超过阈值的回归标记为 "!!"，表示即使按最乐观的估计也超出阈值。
+轮数太少、即使两组完全分开也达不到 p < alpha 时，compare 直接报错。
+"""
+
+import argparse
+import datetime
+import glob
+import json
+import math
+import os
+import platform
+import random
+import statistics
+import subprocess
+import sys
+import tempfile
+
+# 2: 每个用例保存每轮运行的中位数 run_medians_ns，而不是合并的重复采样
+SCHEMA_VERSION = 2
+BASELINE_DIR = "perf_baselines"
+# 自带 main、输出格式不同的 benchmark
+SKIPPED_BENCHES = {"Startup", "DiffWorkload"}
+
+
+def baseline_root(build_dir):
+    return os.path.join(build_dir, BASELINE_DIR)
+
+
+def find_benches(build_dir, backend, names):
+    prefix = os.path.join(build_dir, backend, f"{backend}_bench_")
+    benches = []
+    for path in sorted(glob.glob(prefix + "*")):
+        name = path[len(prefix) :]
+        if name in SKIPPED_BENCHES or (names and name not in names):
+            continue
+        if os.path.isfile(path) and os.access(path, os.X_OK):
+            benches.append((name, path))
+    return benches
+
+
+def backend_version(backend):
+    """尽量记录被测后端的版本，取不到时返回空串"""
+    module = "paddle" if backend == "paddle" else "torch"
+    out = subprocess.run(
+        [sys.executable, "-c", f"import {module}; print({module}.__version__)"],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+    return out.stdout.strip() if out.returncode == 0 else ""
+
+
+def run_benches(build_dir, backend, names, runs, extra_args):
+    """运行 runs 轮，返回 {"<bench>/<case>": [每轮的 median_ns...]}"""
+    benches = find_benches(build_dir, backend, names)
+    if not benches:
+        print(f"Error: no {backend}_bench_* binaries found in {build_dir}")
+        sys.exit(2)
+    samples = {}
+    with tempfile.TemporaryDirectory() as out_dir:
+        json_path = os.path.join(out_dir, "result.json")
+        # 轮流运行各个 benchmark，让机器状态的漂移均匀地落在所有用例上
+        for run in range(runs):
+            for name, binary in benches:
+                print(f"[{backend}] run {run + 1}/{runs}: {name}", flush=True)
+                subprocess.run(
+                    [binary, f"--json={json_path}", *extra_args],
+                    check=True,
+                    stdout=subprocess.DEVNULL,
+                )
+                with open(json_path, "r", encoding="utf-8") as f:
+                    data = json.load(f)
+                for result in data["results"]:
+                    key = f"{name}/{result['name']}"
+                    samples.setdefault(key, []).append(result["median_ns"])
+    return samples
+
+
+def make_baseline(backend, tag, samples):
+    return {
+        "version": SCHEMA_VERSION,
+        "tag": tag,
+        "backend": backend,
+        "backend_version": backend_version(backend),
+        "created": datetime.datetime.now().isoformat(timespec="seconds"),
+        "machine": {
+            "node": platform.node(),
+            "platform": platform.platform(),
+            "processor": platform.processor(),
+            "cpu_count": os.cpu_count(),
+        },
+        "cases": {
+            key: {
+                "median_ns": statistics.median(values),
+                "run_medians_ns": values,
+            }
+            for key, values in sorted(samples.items())
+        },
+    }
+
+
+def save_baseline(build_dir, baseline):
+    tag_dir = os.path.join(baseline_root(build_dir), baseline["tag"])
+    os.makedirs(tag_dir, exist_ok=True)
+    path = os.path.join(tag_dir, f"{baseline['backend']}.json")
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump(baseline, f, indent=1)
+    print(f"saved {len(baseline['cases'])} cases to {path}")
+
+
+def load_baseline(build_dir, tag, backend):
+    path = os.path.join(baseline_root(build_dir), tag, f"{backend}.json")
+    if not os.path.exists(path):
+        print(f"Error: baseline not found: {path}")
+        sys.exit(2)
+    with open(path, "r", encoding="utf-8") as f:
+        baseline = json.load(f)
+    if baseline.get("version") != SCHEMA_VERSION:
+        print(
+            f"Error: {path} has schema version {baseline.get('version')}, "
+            f"expected {SCHEMA_VERSION}; record a new baseline"
+        )
+        sys.exit(2)
+    return baseline
+
+
+def list_tags(build_dir, backend=None):
+    """按创建时间排序的基线 tag 列表"""
+    tags = []
+    for tag_dir in glob.glob(os.path.join(baseline_root(build_dir), "*")):
+        files = glob.glob(os.path.join(tag_dir, "*.json"))
+        if backend:
+            files = [f for f in files if f.endswith(f"{backend}.json")]
+        if files:
+            tags.append((os.path.getmtime(files[0]), os.path.basename(tag_dir)))
+    return [tag for _, tag in sorted(tags)]
+
+
+def min_p_value(n1, n2):
+    """两组完全分开时精确检验能达到的最小双侧 p 值"""
+    return min(1.0, 2 / math.comb(n1 + n2, n1))
+
+
+def exact_u_counts(n1, n2):
+    """无并列时 U 统计量的分布：counts[u] 为 U == u 的排列数"""
+    # table[i][j][u]: i 个 a、j 个 b 中 U == u 的排列数
+    table = [[None] * (n2 + 1) for _ in range(n1 + 1)]
+    for i in range(n1 + 1):
+        for j in range(n2 + 1):
+            if i == 0 or j == 0:
+                table[i][j] = [1]
+                continue
+            # 最大的元素属于 a 时贡献 j，属于 b 时贡献 0
+            counts = [0] * (i * j + 1)
+            for u, c in enumerate(table[i - 1][j]):
+                counts[u + j] += c
+            for u, c in enumerate(table[i][j - 1]):
+                counts[u] += c
+            table[i][j] = counts
+    return table[n1][n2]
+
+
+def mann_whitney_p(a, b):
+    """Mann-Whitney U 检验的双侧 p 值
+
+    样本少且无并列时用精确分布，否则用正态近似（含并列秩与连续性校正）。
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    if n1 <= 20 and n2 <= 20 and len(set(a) | set(b)) == n1 + n2:
+        u = sum(1 for x in a for y in b if x > y)
+        counts = exact_u_counts(n1, n2)
+        total = sum(counts)
+        low = sum(counts[: u + 1]) / total
+        high = sum(counts[u:]) / total
+        return min(1.0, 2 * min(low, high))
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    n = n1 + n2
+    rank_sum_a = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        rank = (i + j) / 2 + 1
+        ties = j - i + 1
+        tie_term += ties**3 - ties
+        in_a = sum(1 for k in range(i, j + 1) if values[k][1] == 0)
+        rank_sum_a += rank * in_a
+        i = j + 1
+    u = rank_sum_a - n1 * (n1 + 1) / 2
+    mean = n1 * n2 / 2
+    var = n1 * n2 / 12 * ((n + 1) - tie_term / (n * (n - 1)))
+    if var <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(var)
+    return math.erfc(max(z, 0.0) / math.sqrt(2))
+
+
+def bootstrap_ratio_ci(base, new, confidence, resamples=2000, seed=0):
+    """中位数比值 median(new) / median(base) 的 bootstrap 百分位置信区间"""
+    rng = random.Random(seed)
+    ratios = []
+    for _ in range(resamples):
+        b = statistics.median(rng.choices(base, k=len(base)))
+        c = statistics.median(rng.choices(new, k=len(new)))
+        if b > 0:
+            ratios.append(c / b)
+    if not ratios:
+        return float("nan"), float("nan")
+    ratios.sort()
+    tail = (1 - confidence) / 2
+    low = ratios[int(tail * (len(ratios) - 1))]
+    high = ratios[int((1 - tail) * (len(ratios) - 1))]
+    return low, high
+
+
+def compare(baseline, candidate, threshold, alpha):
+    """打印对比表，返回回归用例数"""
+    limit = 1 + threshold / 100
+    regressions = 0
+    header = (
+        f"{'case':<56} | {'base ns':>12} | {'new ns':>12} | {'ratio':>6} | "
+        f"{'CI':>15} | {'p':>8} |"
+    )
+    print(header)
+    print("-" * len(header))
+    for key, base in baseline["cases"].items():
+        new = candidate["cases"].get(key)
+        if new is None:
+            continue
+        base_samples = base["run_medians_ns"]
+        new_samples = new["run_medians_ns"]
+        base_median = statistics.median(base_samples)
+        new_median = statistics.median(new_samples)
+        ratio = new_median / base_median if base_median > 0 else float("nan")
+        low, high = bootstrap_ratio_ci(base_samples, new_samples, 1 - alpha)
+        p = mann_whitney_p(base_samples, new_samples)
+        mark = ""
+        if ratio > limit and p < alpha:
+            regressions += 1
+            mark = "!!" if low > limit else "!"
+        elif ratio < 1 / limit and p < alpha:
+            mark = "+"
+        print(
+            f"{key:<56} | {base_median:>12.1f} | {new_median:>12.1f} | "
+            f"{ratio:>6.3f} | [{low:>6.3f},{high:>6.3f}] | {p:>8.2g} | {mark}"
+        )
+    missing = [k for k in baseline["cases"] if k not in candidate["cases"]]
+    for key in missing:
+        print(f"  not in candidate: {key}")
+    return regressions
+
+
+def fewest_runs(baseline):
+    """各用例中最少的运行轮数"""
+    runs = [len(c["run_medians_ns"]) for c in baseline["cases"].values()]
+    return min(runs, default=0)
+
+
+def parse_args():
+    """"--" 之后的参数原样透传给 benchmark 二进制"""
+    argv = sys.argv[1:]
+    bench_args = []
+    if "--" in argv:
+        split = argv.index("--")
+        argv, bench_args = argv[:split], argv[split + 1 :]
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter
+    )
+    sub = parser.add_subparsers(dest="command", required=True)
+    for name in ["record", "compare", "list"]:
+        p = sub.add_parser(name)
+        p.add_argument("build_dir")
+        p.add_argument("--backend", default="paddle")
+        if name == "list":
+            continue
+        p.add_argument(
+            "--runs",
+            type=int,
+            default=5,
+            help="运行轮数，每轮为一个样本；alpha=0.01 时两边至少各 5 轮",
+        )
+        p.add_argument(
+            "--bench",
+            action="append",
+            default=[],
+            help="只运行 <backend>_bench_<BENCH>，可重复",
+        )
+        if name == "record":
+            p.add_argument("--tag", default="")
+        else:
+            p.add_argument("--baseline", default="")
+            p.add_argument("--candidate", default="")
+            p.add_argument("--save", default="", help="同时把本次运行保存为该 tag")
+            p.add_argument("--threshold", type=float, default=5.0)
+            p.add_argument("--alpha", type=float, default=0.01)
+    args = parser.parse_args(argv)
+    args.bench_args = bench_args
+    return args
+
+
+def main():
+    args = parse_args()
+    if args.command == "list":
+        for tag in list_tags(args.build_dir, args.backend):
+            baseline = load_baseline(args.build_dir, tag, args.backend)
+            print(
+                f"{tag:<24} {baseline['created']:<20} "
+                f"{baseline['backend_version']:<16} "
+                f"{len(baseline['cases'])} cases"
+            )
+        return
+
+    if args.command == "record":
+        tag = args.tag or datetime.datetime.now().strftime("%Y%m%d-%H%M%S")
+        samples = run_benches(
+            args.build_dir, args.backend, args.bench, args.runs, args.bench_args
+        )
+        save_baseline(args.build_dir, make_baseline(args.backend, tag, samples))
+        return
+
+    tags = list_tags(args.build_dir, args.backend)
+    baseline_tag = args.baseline or (tags[-1] if tags else "")
+    if not baseline_tag:
+        print("Error: no baseline recorded yet, run 'record' first")
+        sys.exit(2)
+    baseline = load_baseline(args.build_dir, baseline_tag, args.backend)
+    if args.candidate:
+        candidate = load_baseline(args.build_dir, args.candidate, args.backend)
+    else:
+        # 默认只重跑基线中出现过的 benchmark
+        names = args.bench or sorted(
+            {key.split("/", 1)[0] for key in baseline["cases"]}
+        )
+        samples = run_benches(
+            args.build_dir, args.backend, names, args.runs, args.bench_args
+        )
+        tag = args.save or "candidate"
+        candidate = make_baseline(args.backend, tag, samples)
+        if args.save:
+            save_baseline(args.build_dir, candidate)
+
+    base_runs = fewest_runs(baseline)
+    new_runs = fewest_runs(candidate)
+    if min_p_value(base_runs, new_runs) >= args.alpha:
+        print(
+            f"Error: {base_runs} baseline run(s) vs {new_runs} candidate "
+            f"run(s) cannot reach p < {args.alpha}; record more --runs"
+        )
+        sys.exit(2)
+
+    base_version = baseline["backend_version"] or "unknown version"
+    new_version = candidate["backend_version"] or "unknown version"
+    print(
+        f"\n[{args.backend}] baseline {baseline_tag} ({base_version}) vs "
+        f"{candidate['tag']} ({new_version}), "
+        f"threshold {args.threshold}%, alpha {args.alpha}"
+    )
+    regressions = compare(baseline, candidate, args.threshold, args.alpha)
+    print(f"\n{regressions} regression(s)")
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+shape_sweep.py - 随机形状扫描，找出 paddle 明显慢于 torch 的配置（性能断崖）
+
+用法:
+    python tools/shape_sweep.py <build_dir> [--seed 1 --seed 2 ...]
+        [--cases 200] [--max-numel 4194304] [--factor 1.5] [--min-ns 200]
+        [-- bench 参数...]
+
+对每个 seed 运行 <backend>_bench_ShapeSweep（torch 与 paddle 使用相同的
+SHAPE_SWEEP_* 环境变量，因此生成的用例完全一致），按用例对比中位耗时。
+paddle/torch 比值超过 --factor 且 paddle 耗时不低于 --min-ns 的用例被判定为断崖，
+并打印可以直接复现单个用例的命令。有断崖或有只在一个后端失败的用例时退出码为 1。
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+BENCH_NAME = "ShapeSweep"
+# 默认的计时参数比普通 benchmark 短，扫描几百个用例也只需几分钟
+DEFAULT_BENCH_ARGS = ["--min_time_ms=10", "--repetitions=3"]
+
+
+def sweep_env(seed, cases, max_numel):
+    env = dict(os.environ)
+    env["SHAPE_SWEEP_SEED"] = str(seed)
+    env["SHAPE_SWEEP_CASES"] = str(cases)
+    env["SHAPE_SWEEP_MAX_NUMEL"] = str(max_numel)
+    return env
+
+
+def run_sweep(build_dir, backend, env, bench_args, out_dir):
+    binary = os.path.join(build_dir, backend, f"{backend}_bench_{BENCH_NAME}")
+    if not os.path.exists(binary):
+        print(f"Error: benchmark binary not found: {binary}")
+        sys.exit(1)
+    json_path = os.path.join(out_dir, f"{backend}.json")
+    subprocess.run(
+        [binary, f"--json={json_path}", *bench_args],
+        check=True,
+        env=env,
+        stdout=subprocess.DEVNULL,
+    )
+    with open(json_path, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    return {r["name"]: r for r in data["results"]}
+
+
+def case_index(name):
+    """sweep/<index>/... -> index"""
+    return int(name.split("/")[1])
+
+
+def reproducer(build_dir, seed, max_numel, name):
+    index = case_index(name)
+    binary = os.path.join(build_dir, "paddle", f"paddle_bench_{BENCH_NAME}")
+    return (
+        f"SHAPE_SWEEP_SEED={seed} SHAPE_SWEEP_CASES={index + 1} "
+        f"SHAPE_SWEEP_MAX_NUMEL={max_numel} {binary} "
+        f"--filter=sweep/{index}/"
+    )
+
+
+def failed(result):
+    return result.get("counters", {}).get("failed", 0) > 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("build_dir")
+    parser.add_argument("--seed", type=int, action="append")
+    parser.add_argument("--cases", type=int, default=200)
+    parser.add_argument("--max-numel", type=int, default=4 << 20)
+    parser.add_argument("--factor", type=float, default=1.5)
+    parser.add_argument(
+        "--min-ns",
+        type=float,
+        default=200.0,
+        help="忽略 paddle 耗时低于该值的用例，避免计时噪声",
+    )
+    parser.add_argument("bench_args", nargs="*")
+    args = parser.parse_args()
+    seeds = args.seed or [1]
+    bench_args = args.bench_args or DEFAULT_BENCH_ARGS
+
+    cliffs = []
+    mismatched = []
+    total = 0
+    for seed in seeds:
+        env = sweep_env(seed, args.cases, args.max_numel)
+        with tempfile.TemporaryDirectory() as out_dir:
+            torch_results = run_sweep(
+                args.build_dir, "torch", env, bench_args, out_dir
+            )
+            paddle_results = run_sweep(
+                args.build_dir, "paddle", env, bench_args, out_dir
+            )
+        for name, p in paddle_results.items():
+            t = torch_results.get(name)
+            if t is None:
+                continue
+            total += 1
+            if failed(t) != failed(p):
+                backend = "paddle" if failed(p) else "torch"
+                mismatched.append((seed, name, backend))
+                continue
+            if failed(p) or t["median_ns"] <= 0:
+                continue
+            r = p["median_ns"] / t["median_ns"]
+            if r > args.factor and p["median_ns"] >= args.min_ns:
+                cliffs.append((r, seed, name, t["median_ns"], p["median_ns"]))
+
+    print(
+        f"{total} cases over seeds {seeds}, "
+        f"{len(cliffs)} with paddle/torch > {args.factor}"
+    )
+    if cliffs:
+        cliffs.sort(reverse=True)
+        header = (
+            f"{'seed':>6} | {'case':<64} | {'torch ns':>12} | "
+            f"{'paddle ns':>12} | {'p/t':>6}"
+        )
+        print(header)
+        print("-" * len(header))
+        for r, seed, name, t_ns, p_ns in cliffs:
+            print(
+                f"{seed:>6} | {name:<64} | {t_ns:>12.1f} | "
+                f"{p_ns:>12.1f} | {r:>6.2f}"
+            )
+        print("\n复现命令:")
+        for _, seed, name, _, _ in cliffs:
+            print(f"  {reproducer(args.build_dir, seed, args.max_numel, name)}")
+    if mismatched:
+        print("\n只在一个后端失败的用例:")
+        for seed, name, backend in mismatched:
+            command = reproducer(args.build_dir, seed, args.max_numel, name)
+            print(f"  [{backend} failed] seed={seed} {name}")
+            print(f"    {command}")
+
+    sys.exit(1 if cliffs or mismatched else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+startup_bench.py - 冷启动与首个算子延迟对比
+
+用法: python tools/startup_bench.py <build_dir> [runs] [paddle|torch ...]
+
+对每个后端:
+1. 多次启动 <backend>_bench_Startup，统计 exec -> 首个构造函数 (动态加载 + 各动态库
+   静态初始化)、构造函数 -> main、第一次与第二次 at::ones 的耗时中位数;
+2. 以 LD_DEBUG=statistics 运行一次，得到动态链接器加载与重定位的 cycles;
+3. 以 LD_DEBUG=libs 运行一次，按 "calling init" 事件的到达时间估算每个动态库
+   静态初始化的耗时;
+4. 以 LD_DEBUG=bindings 运行一次，统计每个动态库被其他对象绑定的符号数，
+   没有任何符号被绑定的库只是被 DT_NEEDED 拉进来，可以考虑延迟加载 (dlopen)。
+"""
+
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+INIT_RE = re.compile(r"calling init:\s*(\S+)")
+BINDING_RE = re.compile(
+    r"binding file (\S+) \[\d+\] to (\S+) \[\d+\]: \S+ symbol `([^']+)'"
+)
+STARTUP_RE = re.compile(r"total startup time in dynamic loader:\s*(\d+)")
+RELOC_RE = re.compile(r"time needed for relocation:\s*(\d+)")
+LOAD_RE = re.compile(r"time needed to load objects:\s*(\d+)")
+
+
+def run_once(binary):
+    env = dict(os.environ)
+    env["STARTUP_BENCH_EXEC_NS"] = str(time.monotonic_ns())
+    out = subprocess.run(
+        [binary], env=env, capture_output=True, text=True, check=True
+    )
+    return json.loads(out.stdout.strip().splitlines()[-1])
+
+
+def loader_statistics(binary):
+    env = dict(os.environ)
+    env["LD_DEBUG"] = "statistics"
+    out = subprocess.run(
+        [binary], env=env, capture_output=True, text=True, check=True
+    )
+    stats = {}
+    for key, regex in [
+        ("loader_total_cycles", STARTUP_RE),
+        ("relocation_cycles", RELOC_RE),
+        ("load_objects_cycles", LOAD_RE),
+    ]:
+        match = regex.search(out.stderr)
+        stats[key] = int(match.group(1)) if match else 0
+    return stats
+
+
+def init_times(binary):
+    """
+    ld.so 在调用每个库的初始化函数前直接 write 一行 "calling init: <lib>"，
+    相邻两行的到达时间差近似为前一个库的静态初始化耗时。
+    """
+    env = dict(os.environ)
+    env["LD_DEBUG"] = "libs"
+    proc = subprocess.Popen(
+        [binary],
+        env=env,
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.PIPE,
+        text=True,
+        bufsize=1,
+    )
+    events = []
+    for line in proc.stderr:
+        now = time.monotonic_ns()
+        match = INIT_RE.search(line)
+        if match:
+            events.append((match.group(1), now))
+        elif events and "transferring control" in line:
+            events.append(("<main>", now))
+    proc.wait()
+    times = {}
+    for (lib, start), (_, end) in zip(events, events[1:]):
+        times[lib] = (end - start) / 1e6
+    return times
+
+
+def symbol_bindings(binary):
+    """返回 {库路径: 被其他对象绑定的符号数}"""
+    env = dict(os.environ)
+    env["LD_DEBUG"] = "bindings"
+    proc = subprocess.Popen(
+        [binary],
+        env=env,
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.PIPE,
+        text=True,
+    )
+    counts = {}
+    for line in proc.stderr:
+        match = BINDING_RE.search(line)
+        if not match:
+            continue
+        src, dst = match.group(1), match.group(2)
+        if src != dst:
+            counts[dst] = counts.get(dst, 0) + 1
+    proc.wait()
+    return counts
+
+
+def linked_libraries(binary):
+    """ldd 列出的全部依赖库（已解析为绝对路径）"""
+    out = subprocess.run(
+        ["ldd", binary], capture_output=True, text=True, check=False
+    )
+    libs = []
+    for line in out.stdout.splitlines():
+        if "=>" in line:
+            path = line.split("=>")[1].strip().split(" ")[0]
+            if path.startswith("/"):
+                libs.append(os.path.realpath(path))
+    return libs
+
+
+def report_backend(build_dir, backend, runs):
+    binary = os.path.join(build_dir, backend, f"{backend}_bench_Startup")
+    if not os.path.exists(binary):
+        print(f"[{backend}] {binary} not found, skipped")
+        return
+
+    samples = [run_once(binary) for _ in range(runs)]
+    print(f"\n[{backend}] median of {runs} runs")
+    for key in [
+        "exec_to_first_ctor_ms",
+        "first_ctor_to_main_ms",
+        "exec_to_main_ms",
+        "first_ones_us",
+        "second_ones_us",
+    ]:
+        values = [s[key] for s in samples]
+        print(f"  {key:<24} {statistics.median(values):>12.3f}")
+
+    stats = loader_statistics(binary)
+    for key, value in stats.items():
+        print(f"  {key:<24} {value / 1e6:>12.3f} Mcycles")
+
+    inits = init_times(binary)
+    print("\n  static initializers (slowest first)")
+    for lib, ms in sorted(inits.items(), key=lambda kv: -kv[1])[:10]:
+        print(f"    {ms:>10.3f} ms  {lib}")
+
+    bindings = {
+        os.path.realpath(lib): count
+        for lib, count in symbol_bindings(binary).items()
+    }
+    print("\n  linked libraries: symbols bound by other objects")
+    for lib in linked_libraries(binary):
+        count = bindings.get(lib, 0)
+        hint = "  <- lazy-load candidate" if count == 0 else ""
+        print(f"    {count:>8}  {lib}{hint}")
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(
+            f"Usage: python {sys.argv[0]} <build_dir> [runs] [paddle|torch ...]"
+        )
+        sys.exit(1)
+
+    build_dir = sys.argv[1]
+    args = sys.argv[2:]
+    runs = 10
+    if args and args[0].isdigit():
+        runs = int(args[0])
+        args = args[1:]
+    for backend in args or ["paddle", "torch"]:
+        report_backend(build_dir, backend, runs)
+
+
+if __name__ == "__main__":
+    main()